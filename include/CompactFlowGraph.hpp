@@ -0,0 +1,507 @@
+// Frozen, read-only form of the ICFG.
+//
+// FlowGraph is a boost adjacency_list with setS vertex and edge lists, so every
+// vertex and edge is its own heap node and every vertex carries its own strings.
+// That is convenient while ControlFlowPass is still adding and overwriting
+// vertices, but once the graph is finished all that is left is traversal.
+//
+// CompactFlowGraph is built once from a finished FlowGraph:
+//   - vertices are dense uint32_t ids (FlowVertex::index)
+//   - out and in adjacency are CSR arrays, the edge kind is packed into the top bits
+//     of each adjacency entry
+//   - stack names and file names live once in a string table, locations once in a
+//     location table
+//
+// The boost::graph_traits specialization above the class lets read-only
+// consumers (ep::DepthFirstVisitor, vertex_writer, call_writer, BGL_FORALL_*) run on
+// it unchanged. G[v] and G[e] return lightweight views with the same member names as
+// FlowVertex and FlowEdge.
+
+#ifndef COMPACTFLOWGRAPH_HPP
+#define COMPACTFLOWGRAPH_HPP
+
+#include "FlowGraph.hpp"
+#include <boost/graph/iteration_macros.hpp>
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+typedef uint32_t compact_vertex_t;
+
+// Edge kinds, packed into the top bits of each CSR entry
+enum : uint32_t {
+  COMPACT_EDGE_CALL    = 1,
+  COMPACT_EDGE_RET     = 2,
+  COMPACT_EDGE_MAY_RET = 4,
+  COMPACT_EDGE_MAIN    = 8
+};
+
+const unsigned COMPACT_KIND_SHIFT = 28;
+const uint32_t COMPACT_VERTEX_MASK = (1u << COMPACT_KIND_SHIFT) - 1;
+
+struct compact_edge_t {
+  compact_vertex_t src;
+  compact_vertex_t dst;
+  uint32_t kind;
+
+  bool operator==(const compact_edge_t &other) const {
+    return src == other.src && dst == other.dst && kind == other.kind;
+  }
+  bool operator!=(const compact_edge_t &other) const {
+    return !(*this == other);
+  }
+};
+
+// Range over the label ids of one vertex
+struct compact_label_range {
+  const int *first;
+  const int *last;
+
+  const int* begin() const { return first; }
+  const int* end() const { return last; }
+  bool empty() const { return first == last; }
+  size_t size() const { return last - first; }
+};
+
+// What G[v] returns. Same member names as FlowVertex.
+struct CompactVertexRef {
+  const std::string &stack;
+  const Location &loc;
+  llvm::Instruction *I;
+  llvm::Function *F;
+  const mem_t &mem_index;
+  compact_label_range label_ids;
+  unsigned index;
+};
+
+// What G[e] returns. Same member names as FlowEdge.
+struct CompactEdgeRef {
+  explicit CompactEdgeRef(uint32_t kind) :
+    call(kind & COMPACT_EDGE_CALL), ret(kind & COMPACT_EDGE_RET),
+    may_ret(kind & COMPACT_EDGE_MAY_RET), main(kind & COMPACT_EDGE_MAIN) {}
+
+  bool call;
+  bool ret;
+  bool may_ret;
+  bool main;
+};
+
+// Walks one CSR row. Entries are decoded into full edge descriptors.
+class compact_adjacency_iterator
+  : public boost::iterator_facade<compact_adjacency_iterator, compact_edge_t,
+                                  boost::forward_traversal_tag, compact_edge_t> {
+public:
+  compact_adjacency_iterator() : p(nullptr), self(0), out(true) {}
+  compact_adjacency_iterator(const uint32_t *p, compact_vertex_t self, bool out) :
+    p(p), self(self), out(out) {}
+
+private:
+  friend class boost::iterator_core_access;
+
+  compact_edge_t dereference() const {
+    compact_vertex_t other = *p & COMPACT_VERTEX_MASK;
+    uint32_t kind = *p >> COMPACT_KIND_SHIFT;
+    if (out) {
+      return compact_edge_t{self, other, kind};
+    }
+    return compact_edge_t{other, self, kind};
+  }
+
+  bool equal(const compact_adjacency_iterator &other) const {
+    return p == other.p;
+  }
+
+  void increment() {
+    ++p;
+  }
+
+  const uint32_t *p;
+  compact_vertex_t self;
+  bool out;
+};
+
+class CompactFlowGraph;
+
+// Walks every out edge of every vertex
+class compact_edge_iterator
+  : public boost::iterator_facade<compact_edge_iterator, compact_edge_t,
+                                  boost::forward_traversal_tag, compact_edge_t> {
+public:
+  compact_edge_iterator() : G(nullptr), u(0), pos(0) {}
+  compact_edge_iterator(const CompactFlowGraph *G, uint32_t pos);
+
+private:
+  friend class boost::iterator_core_access;
+
+  compact_edge_t dereference() const;
+
+  bool equal(const compact_edge_iterator &other) const {
+    return pos == other.pos;
+  }
+
+  void increment();
+
+  const CompactFlowGraph *G;
+  compact_vertex_t u;
+  uint32_t pos;
+};
+
+namespace boost {
+  template <>
+  struct graph_traits<CompactFlowGraph> {
+    typedef compact_vertex_t vertex_descriptor;
+    typedef compact_edge_t edge_descriptor;
+    typedef compact_adjacency_iterator out_edge_iterator;
+    typedef compact_adjacency_iterator in_edge_iterator;
+    typedef counting_iterator<compact_vertex_t> vertex_iterator;
+    typedef compact_edge_iterator edge_iterator;
+    typedef void adjacency_iterator;
+
+    typedef bidirectional_tag directed_category;
+    typedef disallow_parallel_edge_tag edge_parallel_category;
+    struct traversal_category :
+      public virtual bidirectional_graph_tag,
+      public virtual vertex_list_graph_tag,
+      public virtual edge_list_graph_tag {};
+
+    typedef uint32_t vertices_size_type;
+    typedef uint32_t edges_size_type;
+    typedef uint32_t degree_size_type;
+
+    static vertex_descriptor null_vertex() {
+      return std::numeric_limits<compact_vertex_t>::max();
+    }
+  };
+}
+
+class CompactFlowGraph {
+public:
+  typedef compact_adjacency_iterator out_edge_iterator;
+  typedef compact_adjacency_iterator in_edge_iterator;
+  typedef compact_edge_iterator edge_iterator;
+
+  CompactFlowGraph() {}
+
+  // Freeze a finished FlowGraph
+  explicit CompactFlowGraph(const FlowGraph &FG) {
+    const _FlowGraph &FG_G = FG.G;
+    uint32_t n = FG.num_indices();
+    if (n > COMPACT_VERTEX_MASK) {
+      std::cerr << "FATAL ERROR: Too many vertices for CompactFlowGraph\n";
+      abort();
+    }
+    if (!FG.finalized()) {
+      std::cerr << "FATAL ERROR: CompactFlowGraph built from a FlowGraph that was not finalized\n";
+      abort();
+    }
+
+    // Vertex descriptors by dense index. Indices of removed vertices stay empty.
+    std::vector<flow_vertex_t> by_index(n, nullptr);
+    BGL_FORALL_VERTICES(v, FG_G, _FlowGraph) {
+      by_index[FG_G[v].index] = v;
+    }
+
+    stack_ids.resize(n, 0);
+    loc_ids.resize(n, 0);
+    instructions.resize(n, nullptr);
+    functions.resize(n, nullptr);
+    function_ids.resize(n, 0);
+    label_offsets.reserve(n + 1);
+    label_offsets.push_back(0);
+    locations.push_back(Location());
+
+    std::unordered_map<uint64_t, uint32_t> location_ids;
+    for (uint32_t i = 0; i < n; ++i) {
+      flow_vertex_t v = by_index[i];
+      if (v) {
+        const FlowVertex &fv = FG_G[v];
+        stack_ids[i] = strings.intern(fv.stack);
+        instructions[i] = fv.I;
+        functions[i] = fv.F;
+        function_ids[i] = FG.function(v);
+        if (fv.mem_index) {
+          mem_indexes[i] = fv.mem_index;
+        }
+        labels.insert(labels.end(), fv.label_ids.begin(), fv.label_ids.end());
+
+        if (!fv.loc.empty()) {
+          uint64_t key = (uint64_t) strings.intern(fv.loc.file) << 32 | fv.loc.line;
+          auto it = location_ids.find(key);
+          if (it == location_ids.end()) {
+            it = location_ids.insert(std::make_pair(key, (uint32_t) locations.size())).first;
+            locations.push_back(fv.loc);
+          }
+          loc_ids[i] = it->second;
+        }
+      }
+      label_offsets.push_back(labels.size());
+    }
+
+    vertex_of_string.assign(strings.size(), null_vertex());
+    for (uint32_t i = 0; i < n; ++i) {
+      if (by_index[i]) {
+        vertex_of_string[stack_ids[i]] = i;
+      }
+    }
+
+    // CSR rows, sorted by neighbor id so that the layout does not depend on
+    // where the allocator happened to put the FlowGraph vertices
+    std::vector<std::vector<uint32_t>> out_rows(n), in_rows(n);
+    BGL_FORALL_EDGES(e, FG_G, _FlowGraph) {
+      uint32_t s = FG_G[boost::source(e, FG_G)].index;
+      uint32_t t = FG_G[boost::target(e, FG_G)].index;
+      uint32_t kind = pack_kind(FG_G[e]);
+      out_rows[s].push_back(kind << COMPACT_KIND_SHIFT | t);
+      in_rows[t].push_back(kind << COMPACT_KIND_SHIFT | s);
+    }
+    fill_csr(out_rows, out_offsets, out_adj);
+    fill_csr(in_rows, in_offsets, in_adj);
+
+    for (uint32_t fn = 0; fn < FG.num_functions(); ++fn) {
+      function_names.push_back(FG.function_name(fn));
+    }
+
+    entry = getVertex("main.0");
+  }
+
+  static compact_vertex_t null_vertex() {
+    return std::numeric_limits<compact_vertex_t>::max();
+  }
+
+  uint32_t num_vertices() const {
+    return stack_ids.size();
+  }
+
+  uint32_t num_edges() const {
+    return out_adj.size();
+  }
+
+  compact_vertex_t get_entry() const {
+    return entry;
+  }
+
+  // Lookup the vertex for this stack location
+  // Returns null_vertex() if that stack does not exist in the graph
+  compact_vertex_t getVertex(const std::string &stack) const {
+    uint32_t id;
+    if (!strings.find(stack, id) || id >= vertex_of_string.size()) {
+      return null_vertex();
+    }
+    return vertex_of_string[id];
+  }
+
+  CompactVertexRef operator[](compact_vertex_t v) const {
+    static const mem_t no_mem_index;
+    auto mem = mem_indexes.find(v);
+    const int *label_base = labels.data();
+    return CompactVertexRef{
+      strings.str(stack_ids[v]),
+      locations[loc_ids[v]],
+      instructions[v],
+      functions[v],
+      mem == mem_indexes.end() ? no_mem_index : mem->second,
+      compact_label_range{label_base + label_offsets[v], label_base + label_offsets[v + 1]},
+      v
+    };
+  }
+
+  // Same ids as FlowGraph::function
+  uint32_t function_id(compact_vertex_t v) const {
+    return function_ids[v];
+  }
+
+  const std::string& function_name(uint32_t fn) const {
+    return function_names[fn];
+  }
+
+  uint32_t num_functions() const {
+    return function_names.size();
+  }
+
+  CompactEdgeRef operator[](const compact_edge_t &e) const {
+    return CompactEdgeRef(e.kind);
+  }
+
+  std::pair<out_edge_iterator, out_edge_iterator> out_edges(compact_vertex_t v) const {
+    const uint32_t *base = out_adj.data();
+    return std::make_pair(out_edge_iterator(base + out_offsets[v], v, true),
+                          out_edge_iterator(base + out_offsets[v + 1], v, true));
+  }
+
+  std::pair<in_edge_iterator, in_edge_iterator> in_edges(compact_vertex_t v) const {
+    const uint32_t *base = in_adj.data();
+    return std::make_pair(in_edge_iterator(base + in_offsets[v], v, false),
+                          in_edge_iterator(base + in_offsets[v + 1], v, false));
+  }
+
+  uint32_t out_degree(compact_vertex_t v) const {
+    return out_offsets[v + 1] - out_offsets[v];
+  }
+
+  uint32_t in_degree(compact_vertex_t v) const {
+    return in_offsets[v + 1] - in_offsets[v];
+  }
+
+  void write_graphviz(std::ostream &os) const;
+
+  const StringTable& string_table() const {
+    return strings;
+  }
+
+  // COMPACT_EDGE_* bits for a FlowEdge
+  static uint32_t pack_kind(const FlowEdge &e) {
+    uint32_t kind = 0;
+    if (e.call)    kind |= COMPACT_EDGE_CALL;
+    if (e.ret)     kind |= COMPACT_EDGE_RET;
+    if (e.may_ret) kind |= COMPACT_EDGE_MAY_RET;
+    if (e.main)    kind |= COMPACT_EDGE_MAIN;
+    return kind;
+  }
+
+private:
+  friend class compact_edge_iterator;
+
+  static void fill_csr(std::vector<std::vector<uint32_t>> &rows,
+                       std::vector<uint32_t> &offsets, std::vector<uint32_t> &adj) {
+    offsets.reserve(rows.size() + 1);
+    offsets.push_back(0);
+    for (std::vector<uint32_t> &row : rows) {
+      std::sort(row.begin(), row.end(), [](uint32_t a, uint32_t b) {
+        return (a & COMPACT_VERTEX_MASK) < (b & COMPACT_VERTEX_MASK);
+      });
+      adj.insert(adj.end(), row.begin(), row.end());
+      offsets.push_back(adj.size());
+      std::vector<uint32_t>().swap(row);
+    }
+  }
+
+  // CSR adjacency. Row v is [offsets[v], offsets[v+1]).
+  std::vector<uint32_t> out_offsets, out_adj;
+  std::vector<uint32_t> in_offsets, in_adj;
+
+  // Per-vertex properties, indexed by vertex id
+  std::vector<uint32_t> stack_ids;
+  std::vector<uint32_t> loc_ids;
+  std::vector<llvm::Instruction*> instructions;
+  std::vector<llvm::Function*> functions;
+  std::vector<uint32_t> function_ids;
+  std::vector<uint32_t> label_offsets;
+  std::vector<int> labels;
+
+  // Only indirect calls have a memory index
+  std::unordered_map<compact_vertex_t, mem_t> mem_indexes;
+
+  StringTable strings;
+  std::vector<Location> locations;
+  std::vector<compact_vertex_t> vertex_of_string;
+  std::vector<std::string> function_names;
+
+  compact_vertex_t entry = null_vertex();
+};
+
+inline compact_edge_iterator::compact_edge_iterator(const CompactFlowGraph *G, uint32_t pos) :
+  G(G), u(0), pos(pos) {
+  // Skip to the row holding pos
+  while (u < G->num_vertices() && G->out_offsets[u + 1] <= pos) {
+    ++u;
+  }
+}
+
+inline compact_edge_t compact_edge_iterator::dereference() const {
+  uint32_t packed = G->out_adj[pos];
+  return compact_edge_t{u, packed & COMPACT_VERTEX_MASK, packed >> COMPACT_KIND_SHIFT};
+}
+
+inline void compact_edge_iterator::increment() {
+  ++pos;
+  while (u < G->num_vertices() && G->out_offsets[u + 1] <= pos) {
+    ++u;
+  }
+}
+
+// BGL free functions. Found by ADL for unqualified calls (BGL_FORALL_*, ep::DepthFirstVisitor),
+// and pulled into boost below for boost:: qualified calls made after this header.
+
+inline std::pair<compact_adjacency_iterator, compact_adjacency_iterator>
+out_edges(compact_vertex_t v, const CompactFlowGraph &G) {
+  return G.out_edges(v);
+}
+
+inline std::pair<compact_adjacency_iterator, compact_adjacency_iterator>
+in_edges(compact_vertex_t v, const CompactFlowGraph &G) {
+  return G.in_edges(v);
+}
+
+inline compact_vertex_t source(const compact_edge_t &e, const CompactFlowGraph &) {
+  return e.src;
+}
+
+inline compact_vertex_t target(const compact_edge_t &e, const CompactFlowGraph &) {
+  return e.dst;
+}
+
+inline uint32_t out_degree(compact_vertex_t v, const CompactFlowGraph &G) {
+  return G.out_degree(v);
+}
+
+inline uint32_t in_degree(compact_vertex_t v, const CompactFlowGraph &G) {
+  return G.in_degree(v);
+}
+
+inline uint32_t degree(compact_vertex_t v, const CompactFlowGraph &G) {
+  return G.out_degree(v) + G.in_degree(v);
+}
+
+inline std::pair<boost::counting_iterator<compact_vertex_t>, boost::counting_iterator<compact_vertex_t>>
+vertices(const CompactFlowGraph &G) {
+  return std::make_pair(boost::counting_iterator<compact_vertex_t>(0),
+                        boost::counting_iterator<compact_vertex_t>(G.num_vertices()));
+}
+
+inline uint32_t num_vertices(const CompactFlowGraph &G) {
+  return G.num_vertices();
+}
+
+inline std::pair<compact_edge_iterator, compact_edge_iterator> edges(const CompactFlowGraph &G) {
+  return std::make_pair(compact_edge_iterator(&G, 0), compact_edge_iterator(&G, G.num_edges()));
+}
+
+inline uint32_t num_edges(const CompactFlowGraph &G) {
+  return G.num_edges();
+}
+
+namespace boost {
+  using ::out_edges;
+  using ::in_edges;
+  using ::source;
+  using ::target;
+  using ::out_degree;
+  using ::in_degree;
+  using ::degree;
+  using ::vertices;
+  using ::num_vertices;
+  using ::edges;
+  using ::num_edges;
+}
+
+namespace ep {
+template<>
+struct DenseVertexIndex<CompactFlowGraph> {
+  size_t operator()(compact_vertex_t v, const CompactFlowGraph &) const {
+    return v;
+  }
+};
+}
+
+inline void CompactFlowGraph::write_graphviz(std::ostream &os) const {
+  boost::default_writer w;
+  call_writer<const CompactFlowGraph> cw(*this);
+  vertex_writer<const CompactFlowGraph> vw(*this);
+  boost::write_graphviz(os, *this, vw, cw, w,
+                        boost::typed_identity_property_map<compact_vertex_t>());
+}
+
+#endif
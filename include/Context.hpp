@@ -4,6 +4,7 @@
 #include <vector>
 #include <stack>
 #include <memory>
+#include <unordered_map>
 #include "Path.hpp"
 #include "FlowGraph.hpp"
 #include "Llvm.hpp"
@@ -19,17 +20,52 @@ struct RunMetrics {
 };
 
 typedef std::vector<Path> paths_t;
-typedef std::vector<std::vector<std::string> > output_t;
 typedef std::stack<flow_edge_t> branches_t;
 typedef std::vector<flow_vertex_t> path_t;
 
-output_t k_context(std::shared_ptr<FlowGraph> FG,
-                   flow_vertex_t start, unsigned path_length, RunMetrics &metrics,
-                   bool arg_callinfo, bool err_annotations, p2v::Llvm &passes, std::string return_str);
+// Traversal state of __k_context. The graph itself is only read, so searches
+// with their own SearchContext can run concurrently.
+struct SearchContext {
+  explicit SearchContext(std::shared_ptr<const FlowGraph> FG) :
+    visited(FG->num_indices()), path(FG) {}
+
+  // Indexed by FlowVertex::index, reset at the start of every search
+  VisitedEpochs visited;
+  branches_t B;
+
+  // The path being searched, cleared but not freed between searches
+  Path path;
+
+  RunMetrics metrics;
+};
+
+// Backward paths of one call site bucketed by parent sequence signature, so a
+// forward path only meets the backward paths it is a valid_match for.
+class PathJoinIndex {
+public:
+  explicit PathJoinIndex(paths_t &backward);
+
+  // Indices into backward of every b with f.valid_match(b), in increasing order
+  void matches(Path &f, std::vector<size_t> &out) const;
+
+private:
+  typedef std::unordered_map<PathSignature, std::vector<size_t>, PathSignatureHash> buckets_t;
+
+  // Backward paths by the signature of their whole parent sequence
+  buckets_t whole;
+  // Backward paths by the signature of every strict prefix of their parent sequence
+  buckets_t prefixes;
+};
+
+// Sends every path through the call site start to sink as it is found
+void k_context(std::shared_ptr<FlowGraph> FG,
+               flow_vertex_t start, unsigned path_length, SearchContext &ctx,
+               bool arg_callinfo, bool err_annotations, const p2v::Llvm &passes,
+               std::string return_str, PathSink &sink);
 
 paths_t __k_context(std::shared_ptr<FlowGraph> FG, flow_vertex_t start,
-                    unsigned path_length, bool forward, RunMetrics &metrics,
-                    p2v::Llvm &passes);
+                    unsigned path_length, bool forward, SearchContext &ctx,
+                    const p2v::Llvm &passes);
 
 // Helper Functions
 void call_node(flow_vertex_t v, Path &p, branches_t &B,
@@ -37,6 +73,8 @@ void call_node(flow_vertex_t v, Path &p, branches_t &B,
 
 std::vector<flow_vertex_t> callers(flow_vertex_t v, const FlowGraph &FG);
 
+// With a vocab_path, paths are written to o as a binary corpus (see Corpus.hpp)
+// and its vocabulary to vocab_path instead of as text
 void run_k_context_on_file(std::string bitcode_path,
                            std::string interesting_path,
                            std::ostream &o,
@@ -44,13 +82,16 @@ void run_k_context_on_file(std::string bitcode_path,
                            bool arg_callinfo,
                            bool err_annotations,
                            std::string return_str = "DEFAULT",
-                           std::string error_codes_path = "");
+                           std::string error_codes_path = "",
+                           std::string cache_dir = "",
+                           unsigned threads = 1,
+                           std::string vocab_path = "");
 
 std::vector<flow_vertex_t> get_call_sites(FlowGraph &FG, const std::unordered_set<std::string> &functions);
 
-void add_caller_paths(const FlowGraph &FG, const Path &p, output_t &path_strings);
+void add_caller_paths(const FlowGraph &FG, const Path &p, PathSink &sink);
 
-void add_err_paths(const FlowGraph &FG, Path &p, output_t &path_strings, p2v::Llvm &passes, std::string return_str);
+void add_err_paths(const FlowGraph &FG, Path &p, PathSink &sink, const p2v::Llvm &passes, std::string return_str);
 
 // Single source shortest path to multiple vertices
 // Returns a vector of paths, one path for each vertex in the end vector
@@ -2,11 +2,29 @@
 #define CONTROLFLOW_HPP
 
 #include "Names.hpp"
+#include "FunctionSource.hpp"
 #include "Location.hpp"
 #include "FlowGraph.hpp"
 #include "llvm/Pass.h"
 #include "llvm/IR/Module.h"
+#include <atomic>
+#include <memory>
 #include <unordered_map>
+#include <vector>
+
+// One FlowGraph::add call, recorded while walking a function and replayed later.
+// ret marks the add that connects a return instruction to its block exit.
+struct FlowGraphOp {
+  FlowGraphOp(FlowVertex from, FlowVertex to1, FlowVertex to2, bool ret = false)
+    : from(from), to1(to1), to2(to2), ret(ret) {}
+
+  FlowVertex from;
+  FlowVertex to1;
+  FlowVertex to2;
+  bool ret;
+};
+
+typedef std::vector<FlowGraphOp> FlowGraphOps;
 
 class ControlFlowPass : public llvm::ModulePass {
 public:
@@ -17,13 +35,25 @@ public:
   virtual bool runOnModule(llvm::Module &M) override;
   void runOnFunction(llvm::Function *f);
   void runOnBasicBlock(llvm::BasicBlock *bb);
-  FlowVertex visitInstruction(llvm::Instruction *I, FlowVertex prev);
   void addMayReturnEdges(llvm::Function &F);
-  void addCalls(flow_vertex_t call, FlowVertex ret_v);
   void getAnalysisUsage(llvm::AnalysisUsage &AU) const override;
 
+  // Walking a function only reads the IR and NamesPass, so it can run on worker
+  // threads. The recorded adds are replayed in module order, which makes the graph
+  // identical to a sequential build.
+  void recordFunction(llvm::Function *F, FlowGraphOps &ops);
+  FlowVertex recordInstruction(llvm::Instruction *I, FlowVertex prev, FlowGraphOps &ops);
+  void recordCalls(FlowVertex call_v, FlowVertex ret_v, FlowGraphOps &ops);
+  void replay(llvm::Function *F, const FlowGraphOps &ops);
+
   NamesPass *names;
-  FlowGraph FG;
+  FunctionSourcePass *sources;
+  // Owned by the pass until a client takes it with releaseFlowGraph
+  std::unique_ptr<FlowGraph> FG{new FlowGraph()};
+
+  // Hand the graph over without copying it. FG is null afterwards, but
+  // vertex descriptors (getFunctionVertex) stay valid in the released graph.
+  std::unique_ptr<FlowGraph> releaseFlowGraph();
 
   // Get or generate an id for this value
   void addPredecessorRules(llvm::Instruction*);
@@ -35,6 +65,13 @@ public:
 
   bool remove_cross_folder = false;
 
+  // Call edges dropped by remove_cross_folder
+  std::atomic<unsigned> cross_folder_pruned{0};
+
+  // Worker threads for the per-function walk. 0 means one per core.
+  // Overridden by -cfg-threads when running under opt.
+  unsigned threads = 1;
+
 private:
   unsigned id_cnt = 1;
 
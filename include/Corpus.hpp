@@ -0,0 +1,107 @@
+// Binary sentence corpus written by pathgen --corpus and walkgen --corpus.
+//
+// Text paths and walks spell out every token and are tokenized again by the
+// training tools, which costs as much as generating them on large corpora.
+// A binary corpus is a pair of files instead:
+//
+//   <corpus>        the magic "F2VCORP1", then one record per sentence: a
+//                   LEB128 varint token count followed by that many varint ids
+//   <corpus>.vocab  one token per line, the token on line i (from 0) has id i
+//
+// The vocabulary always starts with the instruction labels at their label ids,
+// followed by every function name in the graph, so for the same bitcode these
+// ids agree between a path corpus and a walk corpus. Tokens only one of the
+// tools produces (RETURN_*, ERR_*, CALLER_*, F2V_*) follow.
+//
+// This file does not depend on LLVM, so training tools can link the corpus
+// library alone and read a corpus with CorpusReader.
+
+#ifndef CORPUS_HPP
+#define CORPUS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ep {
+
+const char CORPUS_MAGIC[8] = {'F', '2', 'V', 'C', 'O', 'R', 'P', '1'};
+
+inline void append_varint(std::string &buf, uint64_t v) {
+  while (v >= 0x80) {
+    buf += (char) (v | 0x80);
+    v >>= 7;
+  }
+  buf += (char) v;
+}
+
+// One sentence record
+inline void append_sentence(std::string &buf, const uint32_t *ids, size_t n) {
+  append_varint(buf, n);
+  for (size_t i = 0; i < n; ++i) {
+    append_varint(buf, ids[i]);
+  }
+}
+
+class CorpusVocabulary {
+public:
+  // Labels are placed at their ids. Ids that no label uses get a placeholder
+  // token so that line numbers stay ids.
+  CorpusVocabulary(const std::unordered_map<int, std::string> &id_to_label,
+                   const std::vector<std::string> &function_names);
+
+  // Id of token. Lookups of tokens that are already in the vocabulary may run
+  // concurrently with each other and with intern.
+  uint32_t intern(const std::string &token);
+
+  size_t size() const;
+
+  // Returns false if the file could not be written
+  bool write(const std::string &path) const;
+
+private:
+  mutable std::mutex m;
+  std::vector<std::string> tokens;
+  std::unordered_map<std::string, uint32_t> ids;
+};
+
+// Read-only view of a corpus file through a memory mapping
+class CorpusReader {
+public:
+  explicit CorpusReader(const std::string &path);
+  ~CorpusReader();
+
+  CorpusReader(const CorpusReader &) = delete;
+  CorpusReader& operator=(const CorpusReader &) = delete;
+
+  // False if the file could not be mapped or is not a corpus
+  bool ok() const {
+    return data != nullptr;
+  }
+
+  // Read the next sentence into ids. Returns false at the end of the corpus or
+  // if the rest of the file is not a well formed sentence.
+  bool next(std::vector<uint32_t> &ids);
+
+  // Start again from the first sentence
+  void rewind();
+
+private:
+  const uint8_t *data = nullptr;
+  const uint8_t *pos = nullptr;
+  const uint8_t *end = nullptr;
+  size_t mapped = 0;
+
+  bool read_varint(uint64_t &v);
+};
+
+// One token per line, as written by CorpusVocabulary::write
+bool read_vocabulary(const std::string &path, std::vector<std::string> &tokens);
+
+}
+
+#endif
@@ -0,0 +1,187 @@
+// Open-addressing hash map for hot lookup tables.
+//
+// Entries live in a deque in insertion order, so iteration is deterministic and
+// references to values stay valid when more keys are added, as with std::map.
+// Lookups go through a power-of-two array of slots probed linearly. Each slot
+// holds the entry index and the top bits of its hash, so a probe only touches
+// the entry when the hash fragment matches. Keys cannot be erased.
+//
+// Only the parts of the std::map interface that NamesPass uses are provided.
+
+#ifndef FLATMAP_HPP
+#define FLATMAP_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+namespace ep {
+
+// Finalizer from MurmurHash3. Spreads low entropy keys over all bits.
+inline uint64_t flat_mix(uint64_t h) {
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+template <typename K>
+struct FlatHash {
+  uint64_t operator()(const K &k) const {
+    return flat_mix(std::hash<K>()(k));
+  }
+};
+
+// Pointers are aligned, so their low bits would all land in the same slots
+template <typename T>
+struct FlatHash<T*> {
+  uint64_t operator()(T *p) const {
+    return flat_mix(reinterpret_cast<uintptr_t>(p));
+  }
+};
+
+template <typename K, typename V, typename Hash = FlatHash<K>>
+class FlatMap {
+public:
+  typedef std::pair<const K, V> value_type;
+  typedef typename std::deque<value_type>::iterator iterator;
+  typedef typename std::deque<value_type>::const_iterator const_iterator;
+
+  FlatMap() : slots(MIN_SLOTS) {}
+
+  iterator begin() { return entries.begin(); }
+  iterator end() { return entries.end(); }
+  const_iterator begin() const { return entries.begin(); }
+  const_iterator end() const { return entries.end(); }
+
+  size_t size() const { return entries.size(); }
+  bool empty() const { return entries.empty(); }
+
+  iterator find(const K &key) {
+    uint32_t idx = lookup(key);
+    return idx == NONE ? entries.end() : entries.begin() + idx;
+  }
+
+  const_iterator find(const K &key) const {
+    uint32_t idx = lookup(key);
+    return idx == NONE ? entries.end() : entries.begin() + idx;
+  }
+
+  size_t count(const K &key) const {
+    return lookup(key) == NONE ? 0 : 1;
+  }
+
+  V& at(const K &key) {
+    uint32_t idx = lookup(key);
+    if (idx == NONE) {
+      std::cerr << "FATAL ERROR: FlatMap::at on missing key\n";
+      abort();
+    }
+    return entries[idx].second;
+  }
+
+  const V& at(const K &key) const {
+    return const_cast<FlatMap*>(this)->at(key);
+  }
+
+  V& operator[](const K &key) {
+    return insert(value_type(key, V())).first->second;
+  }
+
+  // Does not overwrite an existing value
+  std::pair<iterator, bool> insert(const value_type &kv) {
+    uint64_t h = Hash()(kv.first);
+    size_t mask = slots.size() - 1;
+    for (size_t i = h & mask; ; i = (i + 1) & mask) {
+      Slot &slot = slots[i];
+      if (slot.index == NONE) {
+        break;
+      }
+      if (slot.tag == tag(h) && entries[slot.index].first == kv.first) {
+        return std::make_pair(entries.begin() + slot.index, false);
+      }
+    }
+
+    uint32_t idx = entries.size();
+    entries.push_back(kv);
+    if (entries.size() * 4 > slots.size() * 3) {
+      rehash(slots.size() * 2);
+    } else {
+      place(h, idx);
+    }
+    return std::make_pair(entries.begin() + idx, true);
+  }
+
+  // Size the slots for n keys up front
+  void reserve(size_t n) {
+    size_t want = MIN_SLOTS;
+    while (n * 4 > want * 3) {
+      want *= 2;
+    }
+    if (want > slots.size()) {
+      rehash(want);
+    }
+  }
+
+  void clear() {
+    entries.clear();
+    slots.assign(MIN_SLOTS, Slot());
+  }
+
+private:
+  static const uint32_t NONE = UINT32_MAX;
+  static const size_t MIN_SLOTS = 16;
+
+  struct Slot {
+    uint32_t index = NONE;
+    uint32_t tag = 0;
+  };
+
+  static uint32_t tag(uint64_t h) {
+    return h >> 32;
+  }
+
+  uint32_t lookup(const K &key) const {
+    uint64_t h = Hash()(key);
+    size_t mask = slots.size() - 1;
+    for (size_t i = h & mask; ; i = (i + 1) & mask) {
+      const Slot &slot = slots[i];
+      if (slot.index == NONE) {
+        return NONE;
+      }
+      if (slot.tag == tag(h) && entries[slot.index].first == key) {
+        return slot.index;
+      }
+    }
+  }
+
+  void place(uint64_t h, uint32_t idx) {
+    size_t mask = slots.size() - 1;
+    size_t i = h & mask;
+    while (slots[i].index != NONE) {
+      i = (i + 1) & mask;
+    }
+    slots[i].index = idx;
+    slots[i].tag = tag(h);
+  }
+
+  void rehash(size_t n) {
+    slots.assign(n, Slot());
+    for (uint32_t idx = 0; idx < entries.size(); ++idx) {
+      place(Hash()(entries[idx].first), idx);
+    }
+  }
+
+  std::deque<value_type> entries;
+  std::vector<Slot> slots;
+};
+
+}
+
+#endif
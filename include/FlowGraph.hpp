@@ -3,14 +3,19 @@
 
 #include "Utility.hpp"
 #include "Location.hpp"
+#include "StackNames.hpp"
 #include "VarName.hpp"
+#include "VisitedEpochs.hpp"
 #include <llvm/IR/Instruction.h>
 #include <llvm/IR/BasicBlock.h>
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/graphviz.hpp>
+#include <boost/graph/iteration_macros.hpp>
 #include <sstream>
 #include <algorithm>
 #include <tuple>
+#include <memory>
+#include <unordered_map>
 
 struct FlowVertex;
 struct FlowEdge;
@@ -45,14 +50,37 @@ struct FlowVertex {
   FlowVertex(unsigned stack, Location loc, llvm::Instruction *I) :
     FlowVertex(std::to_string(stack), loc, I) {}
 
+  // Keyed constructors. FlowGraph fills in the stack string once, when the
+  // vertex is first added.
+  FlowVertex(stack_key_t key, llvm::Function *F) :
+    key(key), F(F) {}
+
+  FlowVertex(stack_key_t key, Location loc, llvm::Instruction *I) :
+      key(key), loc(loc), I(I) {
+
+    if (I) {
+      F = I->getParent()->getParent();
+    }
+  }
+
+  bool empty() const {
+    return key == 0 && stack.empty();
+  }
+
+  // Interned stack name, see StackNames.hpp. Zero until the vertex is in a FlowGraph
+  // unless it was constructed from a key.
+  stack_key_t key = 0;
   std::string stack;
   Location loc;
   llvm::Instruction *I = nullptr;
 
+  // Dense insertion-order id, assigned by FlowGraph when the vertex is created.
+  // Never overwritten by FlowGraph::add, so side tables can be indexed by it.
+  unsigned index = 0;
+
   // This should always be set when creating vertices unless vertex is completely empty
   llvm::Function* F = nullptr;
 
-  bool visited = false;
   boost::default_color_type color;
 
   // func2vec
@@ -75,6 +103,16 @@ struct FlowEdge {
   bool main = false;
 };
 
+namespace ep {
+// FlowVertex::index is already dense
+template<>
+struct DenseVertexIndex<_FlowGraph> {
+  size_t operator()(flow_vertex_t v, const _FlowGraph &G) const {
+    return G[v].index;
+  }
+};
+}
+
 // Templatized so filtered graphs can be written out
 template <typename GraphTy>
 class vertex_writer {
@@ -116,32 +154,36 @@ class edge_visited_predicate {
 public:
   // Empty constructor because boost
   edge_visited_predicate() {}
-  edge_visited_predicate(_FlowGraph &G) : _G(&G) {}
+  edge_visited_predicate(_FlowGraph &G, const VisitedEpochs &visited) : _G(&G), _visited(&visited) {}
 
   bool operator()(const flow_edge_t E) const {
-    return (*_G)[source(E, *_G)].visited && (*_G)[target(E, *_G)].visited;
+    return _visited->visited((*_G)[source(E, *_G)].index) && _visited->visited((*_G)[target(E, *_G)].index);
   }
 private:
   _FlowGraph *_G;
+  const VisitedEpochs *_visited;
 };
 
 class vertex_visited_predicate {
 public:
   vertex_visited_predicate() {}
-  vertex_visited_predicate(_FlowGraph &G) : _G(&G) {}
+  vertex_visited_predicate(_FlowGraph &G, const VisitedEpochs &visited) : _G(&G), _visited(&visited) {}
 
   bool operator()(const flow_vertex_t V) const {
-    return (*_G)[V].visited;
+    return _visited->visited((*_G)[V].index);
   }
 private:
   _FlowGraph *_G;
+  const VisitedEpochs *_visited;
 };
 
 // Used by write_graphviz to mark vertices visited
 class GraphvizVisitor : public ep::DFSVisitorInterface<_FlowGraph> {
 public:
+  GraphvizVisitor(VisitedEpochs &visited) : visited(visited) {}
+
   virtual void discover_vertex(flow_vertex_t vtx, _FlowGraph &G) {
-    G[vtx].visited = true;
+    visited.mark(G[vtx].index);
   }
 
   virtual bool follow_edge(const flow_edge_t edge, const _FlowGraph &G) const {
@@ -150,6 +192,9 @@ public:
     }
     return false;
   }
+
+private:
+  VisitedEpochs &visited;
 };
 
 class FlowGraph {
@@ -173,22 +218,22 @@ public:
 
   // The other add methods are just wrappers around this.
   add_t add(FlowVertex from, FlowVertex to1, FlowVertex to2) {
-    if (from.stack.empty()) abort();
+    if (from.empty()) abort();
 
     flow_vertex_t vertex_to1 = nullptr, vertex_to2 = nullptr;
-    flow_vertex_t vertex_from = find_or_add_vertex(from.stack);
+    flow_vertex_t vertex_from = find_or_add_vertex(from);
     flow_edge_t edge1, edge2;
-    G[vertex_from] = from;
+    set_properties(vertex_from, from);
 
-    if (!to1.stack.empty()) {
-      vertex_to1 = find_or_add_vertex(to1.stack);
-      G[vertex_to1] = to1;
+    if (!to1.empty()) {
+      vertex_to1 = find_or_add_vertex(to1);
+      set_properties(vertex_to1, to1);
       tie(edge1, std::ignore) = boost::add_edge(vertex_from, vertex_to1, G);
     }
 
-    if (!to2.stack.empty()) {
-      vertex_to2 = find_or_add_vertex(to2.stack);
-      G[vertex_to2] = to2;
+    if (!to2.empty()) {
+      vertex_to2 = find_or_add_vertex(to2);
+      set_properties(vertex_to2, to2);
       tie(edge2, std::ignore) = boost::add_edge(vertex_from, vertex_to2, G);
       G[edge1].call = true;
       G[edge2].ret  = true;
@@ -197,36 +242,57 @@ public:
     return std::make_tuple(vertex_from, vertex_to1, vertex_to2, edge1, edge2);
   }
 
-  flow_vertex_t find_or_add_vertex(std::string stack) {
-    flow_vertex_t v;
+  flow_vertex_t find_or_add_vertex(const FlowVertex &props) {
+    stack_key_t key = props.key ? props.key : stack_names->intern(props.stack);
 
-    if (stack_vertex_map.find(stack) != stack_vertex_map.end()) {
-      v = stack_vertex_map[stack];
-    } else {
-      v = boost::add_vertex(G);
-      stack_vertex_map[stack] = v;
+    auto it = stack_vertex_map.find(key);
+    if (it != stack_vertex_map.end()) {
+      return it->second;
     }
-    G[v].stack = stack;
 
-    if (stack == "main.0") {
+    flow_vertex_t v = boost::add_vertex(G);
+    G[v].index = stack_vertex_map.size();
+    G[v].key = key;
+    G[v].stack = props.key ? stack_names->str(key) : props.stack;
+    stack_vertex_map.insert(std::make_pair(key, v));
+
+    if (G[v].stack == "main.0") {
       entry = v;
     }
 
     return v;
   }
 
+  flow_vertex_t find_or_add_vertex(std::string stack) {
+    return find_or_add_vertex(FlowVertex(stack, nullptr));
+  }
+
   flow_vertex_t get_entry() {
     return entry;
   }
 
   // Lookup the vertex descript for this stack location
   // Returns nullptr if that stack does not exist in the FlowGraph
-  flow_vertex_t getVertex(std::string stack) {
-    if (stack_vertex_map.find(stack) == stack_vertex_map.end()) {
+  flow_vertex_t getVertex(stack_key_t key) const {
+    auto it = stack_vertex_map.find(key);
+    if (it == stack_vertex_map.end()) {
       return nullptr;
     }
+    return it->second;
+  }
+
+  flow_vertex_t getVertex(const std::string &stack) const {
+    return getVertex(stack_names->lookup(stack));
+  }
+
+  // Share the names of the pass that numbers the instructions.
+  // Must be called before any vertex is added.
+  void setStackNames(std::shared_ptr<StackNameTable> names) {
+    stack_names = names;
+  }
 
-    return stack_vertex_map.find(stack)->second;
+  const StackNameTable& getStackNames() const {
+    return *stack_names;
   }
 
   void write_graphviz(std::ostream& os) {
@@ -249,19 +315,17 @@ public:
   }
 
   void write_graphviz(std::ostream& os, std::string stack_start) {
-    for (flow_vertex_t v : boost::make_iterator_range(boost::vertices(G))) {
-      G[v].visited = false;
-    }
-
-    if (stack_vertex_map.find(stack_start) == stack_vertex_map.end()) {
+    flow_vertex_t start = getVertex(stack_start);
+    if (!start) {
       std::cerr << "FATAL ERROR: Filtered dot requested for unknown function\n";
       abort();
     }
 
     // Mark all of the vertices that are reachable from start_stack
-    GraphvizVisitor gv;
+    VisitedEpochs visited(num_indices());
+    GraphvizVisitor gv(visited);
     ep::DepthFirstVisitor<_FlowGraph> visitor(gv);
-    visitor.visit(stack_vertex_map[stack_start], G);
+    visitor.visit(start, G);
 
     // Need a index map because we are using setS for vertex list
     std::map<flow_vertex_t, size_t> index_map;
@@ -269,8 +333,8 @@ public:
       index_map[u] = index_map.size();
     }
 
-    edge_visited_predicate evp(G);
-    vertex_visited_predicate vvp(G);
+    edge_visited_predicate evp(G, visited);
+    vertex_visited_predicate vvp(G, visited);
 
     typedef boost::filtered_graph<_FlowGraph, edge_visited_predicate, vertex_visited_predicate> FilteredTy;
     FilteredTy FilteredG(G, evp, vvp);
@@ -287,12 +351,181 @@ public:
     );
   }
 
+  // Number of vertices ever added. FlowVertex::index is always below this.
+  unsigned num_indices() const {
+    return stack_vertex_map.size();
+  }
+
+  // Compute the per-vertex call and return attributes below. Called once the
+  // graph is finished (end of ControlFlowPass, or after loading it from the
+  // cache); the attributes are stale if the graph changes afterwards.
+  void finalize();
+
+  bool finalized() const {
+    return !attr_flags.empty() || num_indices() == 0;
+  }
+
+  // Function that v belongs to. Ids are dense and name the part of the stack
+  // string before the first '.', so external callees get ids too.
+  uint32_t function(flow_vertex_t v) const {
+    return attr_functions[G[v].index];
+  }
+
+  const std::string& function_name(uint32_t fn) const {
+    return attr_function_names[fn];
+  }
+
+  uint32_t num_functions() const {
+    return attr_function_names.size();
+  }
+
+  // v has a call edge
+  bool is_call(flow_vertex_t v) const {
+    return attr_flags[G[v].index] & ATTR_CALL;
+  }
+
+  // v has no successors or a may_ret successor
+  bool is_return(flow_vertex_t v) const {
+    return attr_flags[G[v].index] & ATTR_RETURN;
+  }
+
+  // Functions entered by the call edges of v, in out-edge order
+  const uint32_t* callees_begin(flow_vertex_t v) const {
+    return attr_callees.data() + attr_callee_offsets[G[v].index];
+  }
+  const uint32_t* callees_end(flow_vertex_t v) const {
+    return attr_callees.data() + attr_callee_offsets[G[v].index + 1];
+  }
+
+  // Target of the ret edge of call site v, nullptr if there is none
+  flow_vertex_t return_site(flow_vertex_t v) const {
+    return attr_return_sites[G[v].index];
+  }
+
+  // Name of what v calls: the memory name of an indirect call, else the first
+  // callee. Empty if v calls nothing.
+  const std::string& call_name(flow_vertex_t v) const {
+    return attr_call_names[attr_call_name_ids[G[v].index]];
+  }
+
   _FlowGraph G;
 
-  std::map<std::string, flow_vertex_t> stack_vertex_map;
+  std::unordered_map<stack_key_t, flow_vertex_t> stack_vertex_map;
 
 private:
   flow_vertex_t entry;
+
+  enum : uint8_t { ATTR_CALL = 1, ATTR_RETURN = 2 };
+
+  // Attributes from finalize, indexed by FlowVertex::index
+  std::vector<uint32_t> attr_functions;
+  std::vector<uint8_t> attr_flags;
+  std::vector<uint32_t> attr_callee_offsets;
+  std::vector<uint32_t> attr_callees;
+  std::vector<flow_vertex_t> attr_return_sites;
+  std::vector<uint32_t> attr_call_name_ids;
+  std::vector<std::string> attr_function_names;
+  // Distinct call names, id 0 is the empty string
+  std::vector<std::string> attr_call_names;
+
+  std::shared_ptr<StackNameTable> stack_names = std::make_shared<StackNameTable>();
+
+  // Overwrite the properties of v, keeping the index and name assigned at creation
+  void set_properties(flow_vertex_t v, const FlowVertex &props) {
+    unsigned index = G[v].index;
+    stack_key_t key = G[v].key;
+    std::string stack = std::move(G[v].stack);
+    G[v] = props;
+    G[v].index = index;
+    G[v].key = key;
+    G[v].stack = std::move(stack);
+  }
 };
 
+inline void FlowGraph::finalize() {
+  unsigned n = num_indices();
+  attr_functions.assign(n, 0);
+  attr_flags.assign(n, 0);
+  attr_callee_offsets.assign(n + 1, 0);
+  attr_callees.clear();
+  attr_return_sites.assign(n, nullptr);
+  attr_call_name_ids.assign(n, 0);
+  attr_function_names.clear();
+  attr_call_names.assign(1, "");
+
+  std::unordered_map<std::string, uint32_t> function_ids, call_name_ids;
+  call_name_ids.insert(std::make_pair("", 0));
+  auto intern = [](std::unordered_map<std::string, uint32_t> &ids,
+                   std::vector<std::string> &names, const std::string &s) {
+    auto it = ids.find(s);
+    if (it != ids.end()) {
+      return it->second;
+    }
+    uint32_t id = names.size();
+    names.push_back(s);
+    ids.insert(std::make_pair(s, id));
+    return id;
+  };
+
+  // Number functions in vertex index order, so ids do not depend on where the
+  // allocator put the vertices
+  std::vector<flow_vertex_t> by_index(n, nullptr);
+  BGL_FORALL_VERTICES(v, G, _FlowGraph) {
+    by_index[G[v].index] = v;
+  }
+  for (flow_vertex_t v : by_index) {
+    if (v) {
+      const std::string &stack = G[v].stack;
+      attr_functions[G[v].index] = intern(function_ids, attr_function_names, stack.substr(0, stack.find(".")));
+    }
+  }
+
+  BGL_FORALL_VERTICES(v, G, _FlowGraph) {
+    unsigned i = G[v].index;
+    if (boost::out_degree(v, G) == 0) {
+      attr_flags[i] |= ATTR_RETURN;
+    }
+    BGL_FORALL_OUTEDGES(v, e, G, _FlowGraph) {
+      if (G[e].call) {
+        attr_flags[i] |= ATTR_CALL;
+        attr_callee_offsets[i + 1]++;
+      }
+      if (G[e].may_ret) {
+        attr_flags[i] |= ATTR_RETURN;
+      }
+      if (G[e].ret) {
+        attr_return_sites[i] = boost::target(e, G);
+      }
+    }
+  }
+  for (unsigned i = 0; i < n; ++i) {
+    attr_callee_offsets[i + 1] += attr_callee_offsets[i];
+  }
+
+  attr_callees.resize(attr_callee_offsets[n]);
+  BGL_FORALL_VERTICES(v, G, _FlowGraph) {
+    unsigned i = G[v].index;
+    uint32_t next = attr_callee_offsets[i];
+    std::string name;
+
+    // Indirect call
+    if (G[v].mem_index) {
+      name = G[v].mem_index->name();
+      std::replace(name.begin(), name.end(), '.', '_');
+    }
+
+    BGL_FORALL_OUTEDGES(v, e, G, _FlowGraph) {
+      if (G[e].call) {
+        uint32_t callee = attr_functions[G[boost::target(e, G)].index];
+        if (name.empty() && next == attr_callee_offsets[i]) {
+          name = attr_function_names[callee];
+        }
+        attr_callees[next++] = callee;
+      }
+    }
+
+    attr_call_name_ids[i] = intern(call_name_ids, attr_call_names, name);
+  }
+}
+
 #endif
@@ -0,0 +1,56 @@
+// Source file of every defined function, computed once per module.
+//
+// The file is taken from the first instruction in the function that has a
+// debug location. The component is the top-level directory of that file
+// (e.g. "fs" for fs/ext4/inode.c), which is what --remove-cross-folder compares.
+
+#ifndef FUNCTIONSOURCE_HPP
+#define FUNCTIONSOURCE_HPP
+
+#include "StackNames.hpp"
+#include "llvm/Pass.h"
+#include "llvm/IR/DebugInfo.h"
+#include "llvm/IR/Function.h"
+#include <unordered_map>
+
+namespace ep {
+  // Debug location of the first instruction in F that has one, or nullptr
+  const llvm::DILocation* getFirstDebugLoc(const llvm::Function &F);
+}
+
+struct FunctionSource {
+  // Ids in FunctionSourcePass's string table. 0 when F has no debug info.
+  uint32_t file = 0;
+  uint32_t component = 0;
+};
+
+class FunctionSourcePass : public llvm::ModulePass {
+public:
+  static char ID;
+  FunctionSourcePass() : llvm::ModulePass(ID) {}
+
+  bool runOnModule(llvm::Module &M) override;
+  void getAnalysisUsage(llvm::AnalysisUsage &AU) const override;
+
+  // Empty FunctionSource for declarations and functions without debug info
+  FunctionSource getSource(const llvm::Function *F) const;
+
+  const std::string& str(uint32_t id) const {
+    return strings.str(id);
+  }
+
+  // False if both functions are known to live in different top-level directories.
+  // Headers under include/ are shared by everyone.
+  bool sameComponent(const llvm::Function *F1, const llvm::Function *F2) const {
+    uint32_t c1 = getSource(F1).component;
+    uint32_t c2 = getSource(F2).component;
+    return c1 == c2 || c1 == include_id || c2 == include_id;
+  }
+
+private:
+  std::unordered_map<const llvm::Function*, FunctionSource> sources;
+  StringTable strings;
+  uint32_t include_id = 0;
+};
+
+#endif
@@ -0,0 +1,66 @@
+// On-disk cache of the ICFG and everything the tools take from the LLVM frontend.
+//
+// The cache file is named by an MD5 of the bitcode, the error-codes file, the
+// flags that change the graph and the format version, so a stale file is never
+// picked up. The file is a header followed by flat, 8-byte aligned arrays of
+// fixed-size records and string ids. Loading maps the file and reads the arrays
+// in one sequential pass, copying them into a new FlowGraph adjacency_list; what
+// it saves is parsing the bitcode and running the LLVM passes.
+//
+// getgraph and pathgen skip the frontend entirely on a hit. tracegen still needs
+// the IR for its own passes, but skips ControlFlowPass and reattaches the
+// Instruction and Function pointers with bind_graph_to_module.
+
+#ifndef GRAPHCACHE_HPP
+#define GRAPHCACHE_HPP
+
+#include "FlowGraph.hpp"
+#include "Names.hpp"
+#include "llvm/IR/Module.h"
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace p2v {
+
+// Bump whenever the layout of the cache file changes
+const uint32_t GRAPH_CACHE_VERSION = 2;
+
+// Everything besides the graph that is stored in the cache
+struct GraphCacheMeta {
+  std::unordered_map<int, std::string> id_to_label;
+  std::map<std::string, std::set<std::string>> bootstrap_fns;
+
+  unsigned cross_folder_pruned = 0;
+
+  // Filled by read_graph_cache for bind_graph_to_module, indexed by FlowVertex::index.
+  // vertex_function is an index into function_names, 0 for vertices without a Function.
+  std::vector<std::string> function_names;
+  std::vector<uint32_t> vertex_function;
+  std::vector<bool> vertex_has_instruction;
+};
+
+// Path of the cache file for these inputs inside cache_dir.
+// Returns an empty string if an input cannot be read.
+std::string graph_cache_path(const std::string &cache_dir, const std::string &bitcode_path,
+                             const std::string &ec_path, bool remove_cross_folder);
+
+// Returns false if the file could not be written. A failed write never leaves
+// a partial cache file behind.
+bool write_graph_cache(const std::string &path, const FlowGraph &FG, const GraphCacheMeta &meta);
+
+// Returns nullptr if the file is missing, truncated or from another version.
+// Vertices of the returned graph have no Instruction or Function pointers.
+std::unique_ptr<FlowGraph> read_graph_cache(const std::string &path, GraphCacheMeta &meta);
+
+// Restore the Instruction and Function pointers of a cached graph.
+// M must be the module the cache was built from, and names must have run on it.
+void bind_graph_to_module(FlowGraph &FG, llvm::Module &M, NamesPass &names,
+                          const GraphCacheMeta &meta);
+
+}
+
+#endif
@@ -0,0 +1,64 @@
+// std::ostream that gzip-compresses everything written to it into another
+// stream, for tools whose text output is large (pathgen -z).
+//
+// The gzip member is finished by close() or the destructor. Data written
+// after that is an error.
+
+#ifndef GZIPSTREAM_HPP
+#define GZIPSTREAM_HPP
+
+#include <ostream>
+#include <streambuf>
+#include <vector>
+#include <zlib.h>
+
+namespace ep {
+
+class GzipStreamBuf : public std::streambuf {
+public:
+  explicit GzipStreamBuf(std::ostream &out, int level = Z_DEFAULT_COMPRESSION);
+  ~GzipStreamBuf();
+
+  GzipStreamBuf(const GzipStreamBuf &) = delete;
+  GzipStreamBuf& operator=(const GzipStreamBuf &) = delete;
+
+  // Compress what is left and write the gzip trailer.
+  // Returns false if zlib or the underlying stream failed.
+  bool finish();
+
+protected:
+  int_type overflow(int_type c) override;
+  int sync() override;
+
+private:
+  std::ostream &out;
+  z_stream zs;
+  std::vector<char> in;
+  std::vector<char> compressed;
+  bool ok = true;
+  bool finished = false;
+
+  // Compress the pending input with the given zlib flush mode
+  bool deflate_pending(int flush);
+};
+
+class GzipOStream : public std::ostream {
+public:
+  explicit GzipOStream(std::ostream &out, int level = Z_DEFAULT_COMPRESSION) :
+    std::ostream(nullptr), buf(out, level) {
+    rdbuf(&buf);
+  }
+
+  void close() {
+    if (!buf.finish()) {
+      setstate(std::ios::badbit);
+    }
+  }
+
+private:
+  GzipStreamBuf buf;
+};
+
+}
+
+#endif
@@ -3,6 +3,7 @@
 
 #include "Location.hpp"
 #include "FlowGraph.hpp"
+#include "PostDomCache.hpp"
 #include "llvm/Pass.h"
 #include "llvm/IR/Function.h"
 #include "llvm/IR/Function.h"
@@ -11,15 +12,37 @@
 #include "llvm/IR/Instructions.h"
 #include <vector>
 
+namespace llvm {
+class MemoryDependenceAnalysis;
+class PostDominatorTree;
+}
+class NamesPass;
+class BranchSafetyPass;
+
 // This is a FunctionPass because I could not figure out
 // how to get MDA to run from a ModulePass
 class HandlersPass : public llvm::FunctionPass {
 public:
   static char ID;
-  HandlersPass() : FunctionPass(ID) {}
+  // postdoms may be shared with anything else that asks about the same module
+  explicit HandlersPass(std::shared_ptr<ep::PostDomCache> postdoms = nullptr)
+    : FunctionPass(ID),
+      postdoms(postdoms ? std::move(postdoms) : std::make_shared<ep::PostDomCache>()) {}
 
   bool runOnFunction(llvm::Function &F) override;
+  bool doFinalization(llvm::Module &M) override;
   void getAnalysisUsage(llvm::AnalysisUsage &AU) const override;
+
+  // Per-function cost of runOnFunction, in visit order
+  struct FunctionTiming {
+    std::string function;
+    unsigned branches = 0;     // conditional branches on an icmp
+    unsigned loads = 0;        // memory-dependence queries
+    unsigned handlers = 0;     // branches resolved to an EH vertex triple
+    double seconds = 0;
+  };
+  std::vector<FunctionTiming> timings;
+  double total_seconds = 0;
    
   // List of branch locations that are potentially error handlers
   // Uses by Traces
@@ -41,12 +64,22 @@ public:
   std::map<std::string, std::tuple<std::string, std::string, std::string>> eh_vertices;
 
 private:
-  void addBranchIfCall(llvm::BranchInst *branch, llvm::Value *maybe_call);
+  void addBranchIfCall(llvm::BranchInst *branch, llvm::Value *maybe_call, NamesPass &names);
 
-  // Populates eh_pairs map
-  void fillEHVertices(llvm::Function &F);
+  // Follows the icmp feeding a conditional branch back to the call it tests
+  void addReturningFunction(llvm::BranchInst *branch, NamesPass &names,
+                            llvm::MemoryDependenceAnalysis &MDA, FunctionTiming &timing);
+
+  // Populates eh_vertices and handler_to_branch for one branch given its
+  // (not handler, handler) blocks from BranchSafety.
+  // Returns false if the branch has no separate handler.
+  bool fillEHVertices(llvm::BranchInst *branch,
+                      std::pair<llvm::BasicBlock*, llvm::BasicBlock*> branch_blocks,
+                      NamesPass &names, llvm::PostDominatorTree &postdom);
 
   std::unordered_set<llvm::BranchInst*> eh_branches;
+
+  std::shared_ptr<ep::PostDomCache> postdoms;
 };
 
 #endif
@@ -2,6 +2,7 @@
 #define PROGRAM2VEC_LLVM_HPP
 
 #include "FlowGraph.hpp"
+#include "CompactFlowGraph.hpp"
 #include "Names.hpp"
 #include "ControlFlow.hpp"
 #include "ReturnValuesPass.hpp"
@@ -15,11 +16,19 @@ namespace p2v {
 
   class Llvm {
   public:
-    Llvm(string bitcode_path, string error_codes_path="", bool remove_cross_folder=false);
+    // cfg_threads is the number of workers used to build the ICFG (0 = all cores)
+    // If cache_dir is set, the graph and labels are loaded from there when the
+    // inputs are unchanged, and stored there otherwise. See GraphCache.hpp.
+    Llvm(string bitcode_path, string error_codes_path="", bool remove_cross_folder=false,
+         unsigned cfg_threads=1, string cache_dir="");
 
     // Get a pointer to the FlowGraph.
     std::shared_ptr<FlowGraph> getFlowGraph() const;
 
+    // Get the frozen, read-only graph. Built on first request, after all
+    // passes have finished, so it includes the instruction labels.
+    std::shared_ptr<const CompactFlowGraph> getCompactFlowGraph() const;
+
     // Get a copy of the bootstrap function sets.
     std::map<std::string, std::set<string>> getBootstrapFns() const;
 
@@ -34,10 +43,15 @@ namespace p2v {
     std::map<std::string, std::string> handler_to_branch;
     std::unordered_map<int, std::string> id_to_label;
 
+    // Metrics
+    unsigned cross_folder_pruned = 0;
+    bool loaded_from_cache = false;
+
   private:
     // FlowGraph is heap allocated in constructor. Shared ownership so
     // that FlowGraph can still be used after passes object passes out of scope.
     std::shared_ptr<FlowGraph> FG;
+    mutable std::shared_ptr<const CompactFlowGraph> CFG;
 
     std::map<std::string, std::set<string>> bootstrap_fns;
   };
@@ -35,10 +35,14 @@
 
 #include "llvm/Pass.h"
 #include "VarName.hpp"
+#include "StackNames.hpp"
+#include "FlatMap.hpp"
 #include "llvm/IR/Function.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/IR/InstVisitor.h"
+#include <map>
 #include <set>
+#include <unordered_map>
 #include <unordered_set>
 #include <queue>
 
@@ -67,6 +71,14 @@ public:
   // Get the name to use for a call to a function
   string getCallName(llvm::Function &F);
 
+  // Interned versions of the three above. These do not build strings.
+  stack_key_t getStackKey(llvm::Instruction &I);
+  pair<stack_key_t, stack_key_t> getBBKeys(llvm::BasicBlock &BB);
+  stack_key_t getCallKey(llvm::Function &F);
+
+  // Table that turns stack keys back into strings
+  std::shared_ptr<StackNameTable> getStackNames() const;
+
   // Get the names of all of the functions called
   std::vector<string> getCalleeNames(const llvm::CallInst &CI);
 
@@ -113,27 +125,34 @@ public:
 
 private:
   // Core name maps
-  map<const llvm::Value*, vn_t> names;
+  // Hashed by pointer: every visit and every getVarName goes through these
+  ep::FlatMap<const llvm::Value*, vn_t> names;
   map<int, vn_t> error_names;
 
-  // The memory model is indexed by MemoryNames (GEP indexes)
-  map<VarName, vn_t>      memory_model;
+  // The memory model is indexed by MemoryNames (GEP indexes), keyed by name()
+  ep::FlatMap<std::string, vn_t> memory_model;
 
   // Load -> memory model index
-  map<const llvm::Value*, mem_t> load_index;
+  ep::FlatMap<const llvm::Value*, mem_t> load_index;
 
-  map<llvm::Function*, VarName> return_names;
+  ep::FlatMap<llvm::Function*, VarName> return_names;
   
   // Values that we know are not ECs in a block
-  map<llvm::BasicBlock*, set<llvm::Value*>> safe_values;
+  ep::FlatMap<llvm::BasicBlock*, set<llvm::Value*>> safe_values;
 
-  map<llvm::Function*, set<llvm::Value*>> locals;
+  ep::FlatMap<llvm::Function*, set<llvm::Value*>> locals;
 
   vn_t EC_OK = make_shared<ErrorName>("OK");
 
-  map<llvm::Instruction*, string> stack_iids;
+  // Instructions are numbered in module order in runOnModule
+  ep::FlatMap<const llvm::Instruction*, unsigned> stack_iids;
+  ep::FlatMap<const llvm::Function*, uint32_t> function_ids;
+  std::shared_ptr<StackNameTable> stack_names = std::make_shared<StackNameTable>();
   unsigned stack_cnt = 1; 
 
+  uint32_t getFunctionId(const llvm::Function &F);
+  unsigned getInstructionId(const llvm::Instruction &I);
+
   unsigned dummy_cnt = 1;
   unsigned intermediate_cnt = 1;
 
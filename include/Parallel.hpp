@@ -0,0 +1,61 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace ep {
+
+// Number of workers to use when the user asks for "all of them" (0)
+inline unsigned resolve_threads(unsigned requested) {
+  if (requested) {
+    return requested;
+  }
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Call fn(worker, i) for every i in [0, n) on up to threads workers, where
+// worker is in [0, threads) and no two calls with the same worker overlap.
+// Use it to give every worker its own scratch state.
+// Indices are handed out one at a time, so uneven items balance out.
+// Everything runs on the calling thread, as worker 0, when threads <= 1.
+template <typename Fn>
+void parallel_for_worker(size_t n, unsigned threads, Fn fn) {
+  if (threads <= 1 || n <= 1) {
+    for (size_t i = 0; i < n; ++i) {
+      fn(0u, i);
+    }
+    return;
+  }
+
+  std::atomic<size_t> next(0);
+  auto worker = [&](unsigned w) {
+    for (size_t i = next++; i < n; i = next++) {
+      fn(w, i);
+    }
+  };
+
+  unsigned workers = std::min<size_t>(threads, n);
+  std::vector<std::thread> pool;
+  pool.reserve(workers - 1);
+  for (unsigned t = 1; t < workers; ++t) {
+    pool.emplace_back(worker, t);
+  }
+  worker(0);
+  for (std::thread &t : pool) {
+    t.join();
+  }
+}
+
+// Call fn(i) for every i in [0, n) on up to threads workers.
+// fn must not touch shared state that another index writes.
+template <typename Fn>
+void parallel_for(size_t n, unsigned threads, Fn fn) {
+  parallel_for_worker(n, threads, [&](unsigned, size_t i) { fn(i); });
+}
+}
+
+#endif
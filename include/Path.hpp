@@ -2,105 +2,254 @@
 #define PATH_HPP
 
 #include "FlowGraph.hpp"
+#include <llvm/ADT/SmallVector.h>
+#include <unordered_set>
 
-// TODO: Add call property to vertices and dispense with this.
-inline bool is_call(const FlowGraph &FG, flow_vertex_t v) {
-  BGL_FORALL_OUTEDGES(v, e, FG.G, _FlowGraph) {
-    if (FG.G[e].call) return true;
+// 128-bit hash of a sequence of call sites, used to deduplicate paths without
+// building their callsite strings. Build with -DCHECK_PATH_SIGNATURES to
+// compare against the strings and abort on a collision.
+struct PathSignature {
+  uint64_t lo = 0;
+  uint64_t hi = 0;
+
+  bool operator==(const PathSignature &other) const {
+    return lo == other.lo && hi == other.hi;
+  }
+
+  // Signature of this sequence followed by key
+  PathSignature extend(stack_key_t key) const {
+    PathSignature ret;
+    ret.lo = mix(lo ^ key);
+    ret.hi = mix(hi + (key ^ 0x9e3779b97f4a7c15ull) * 0xff51afd7ed558ccdull);
+    return ret;
+  }
+
+  // Signature of the pair (first, second)
+  static PathSignature join(const PathSignature &first, const PathSignature &second) {
+    PathSignature ret;
+    ret.lo = mix(first.lo ^ mix(second.hi + 1));
+    ret.hi = mix(first.hi + mix(second.lo ^ 0xc4ceb9fe1a85ec53ull));
+    return ret;
+  }
+
+private:
+  static uint64_t mix(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+  }
+};
+
+struct PathSignatureHash {
+  size_t operator()(const PathSignature &s) const {
+    return s.lo;
   }
-  return false;
-}
+};
+
+// Set of path signatures. callsites() spells out the sequence behind sig and is
+// only called when CHECK_PATH_SIGNATURES is defined.
+class PathSignatureSet {
+public:
+  template <typename Fn>
+  bool contains(const PathSignature &sig, Fn callsites) const {
+#ifdef CHECK_PATH_SIGNATURES
+    auto it = seen.find(sig);
+    if (it == seen.end()) {
+      return false;
+    }
+    check(it->second, callsites());
+    return true;
+#else
+    (void) callsites;
+    return seen.find(sig) != seen.end();
+#endif
+  }
+
+  // Returns false if sig was already in the set
+  template <typename Fn>
+  bool insert(const PathSignature &sig, Fn callsites) {
+#ifdef CHECK_PATH_SIGNATURES
+    std::string s = callsites();
+    auto it = seen.insert(std::make_pair(sig, s));
+    if (!it.second) {
+      check(it.first->second, s);
+    }
+    return it.second;
+#else
+    (void) callsites;
+    return seen.insert(sig).second;
+#endif
+  }
+
+private:
+#ifdef CHECK_PATH_SIGNATURES
+  std::unordered_map<PathSignature, std::string, PathSignatureHash> seen;
+
+  static void check(const std::string &seen_callsites, const std::string &callsites) {
+    if (seen_callsites != callsites) {
+      std::cerr << "FATAL ERROR: Path signature collision between " << seen_callsites
+                << " and " << callsites << "\n";
+      abort();
+    }
+  }
+#else
+  std::unordered_set<PathSignature, PathSignatureHash> seen;
+#endif
+};
+
+// Receives paths one token at a time, so they can be written out as they are
+// found instead of collected first. Paths are never empty.
+class PathSink {
+public:
+  virtual ~PathSink() {}
+  virtual void begin_path() = 0;
+  virtual void token(const std::string &s) = 0;
+  virtual void end_path() = 0;
+};
 
+// A path through the ICFG and the calls it outputs.
+//
+// Storage is inline for paths of typical length, so copying a path into a
+// result list does not allocate. Functions are tracked by FlowGraph id:
+// parents holds the run-length encoded sequence of functions along the path,
+// and parent_bits is a one-word bitmap over it (bit fn % 64) that answers most
+// "is this function on the path" questions without scanning it.
 class Path {
 public:
-  // Empty path. Operations on empty path are currently undefined.
-  Path() : FG(nullptr) {}
-  Path(std::shared_ptr<FlowGraph> FG) : FG(FG) {}
-  Path(std::shared_ptr<FlowGraph> FG, std::string prefix) : FG(FG), prefix(prefix) {}
+  typedef llvm::SmallVector<flow_vertex_t, 64> vertices_t;
+  typedef llvm::SmallVector<flow_vertex_t, 16> output_vertices_t;
 
-  Path(const Path &other);
+  // Empty path. Operations on empty path are currently undefined.
+  Path() {}
+  Path(std::shared_ptr<const FlowGraph> FG) : FG(FG) {}
+  Path(std::shared_ptr<const FlowGraph> FG, std::string prefix) : FG(FG), prefix(prefix) {}
 
-  std::vector<flow_vertex_t> output_vertices;
+  // backward reversed without its first vertex, followed by forward. Same as
+  // copying backward, removing its first vertex, reversing and adding every
+  // vertex of forward, without recomputing the output calls of backward.
+  static Path join(const Path &backward, const Path &forward);
 
   unsigned calls_in_path() const;
   unsigned size() const;
   bool empty() const;
 
+  // Forget every vertex but keep the storage, so one path can be reused for
+  // the searches of many call sites
+  void clear();
+
   // Use this to add a vertex to the path
   void add(flow_vertex_t v);
   void remove(flow_vertex_t v);
-  void remove_call(std::string call);
+  void remove_call(const std::string &call);
 
   void reverse();
   
-  const std::vector<flow_vertex_t>& get_vertices() const;
-  const std::vector<flow_vertex_t>& get_output_vertices() const;
+  const vertices_t& get_vertices() const;
+  const output_vertices_t& get_output_vertices() const;
   std::vector<std::string> output();
+  // Same tokens as output(), sent to sink as one path if there are any.
+  // Returns false if there were none.
+  bool output(PathSink &sink);
+  bool has_output();
   std::string get_callsite_sequence_idx() const;
 
-  // Removes nodes from path up to v and unmarks them on graph FG
-  void rewind(flow_vertex_t v);
+  // Hash of the sequence get_callsite_sequence_idx spells out, kept up to date
+  // as vertices are added and rewound
+  PathSignature signature() const {
+    return output_signatures.empty() ? PathSignature() : output_signatures.back();
+  }
+
+  // Removes nodes from path up to v and unmarks them in visited
+  void rewind(flow_vertex_t v, VisitedEpochs &visited);
   bool needs_rewind(flow_vertex_t v);
 
   // Find the first function change and compare.
   // If this matches with the other path, then call / return line up.
   // If either path does not cross into a new function, then they do match.
-  bool valid_match(Path &other);
+  bool valid_match(const Path &other) const;
+
+  // Element i is the signature of the first i + 1 functions of
+  // get_parent_sequence(). Two paths are a valid_match exactly when one of
+  // these lists is a prefix of the other.
+  std::vector<PathSignature> parent_prefix_signatures() const;
 
   // What function is being called by vertex v?
-  std::string call_name(flow_vertex_t v) const;
+  const std::string& call_name(flow_vertex_t v) const {
+    return FG->call_name(v);
+  }
 
   std::string str();
 
+  std::vector<std::string> get_parent_sequence() const;
+
   // Used for RETURN_ tokens
   std::unordered_set<flow_vertex_t> handler_on;
   std::unordered_set<flow_vertex_t> no_handler_on;
   std::string return_str;
     
 private:
-  std::vector<flow_vertex_t> vertices;
-  
-  // Prefer pointer over reference because we want to be able to put
-  // paths in containers. References are not assignable.
-  std::shared_ptr<FlowGraph> FG;
-
-  std::string prefix;  
+  // A maximal run of consecutive vertices in one function
+  struct ParentRun {
+    uint32_t function;
+    // Position in vertices of the first vertex of the run
+    uint32_t start;
+  };
 
-  bool parents_valid = true;
-  std::vector<std::string> parent_sequence;
+  vertices_t vertices;
+  output_vertices_t output_vertices;
 
-  bool in_parent_sequence(const std::string &function_name);
-  bool is_output_call(flow_vertex_t v);
+  // output_signatures[i] is the signature of output_vertices[0..i]
+  llvm::SmallVector<PathSignature, 16> output_signatures;
 
-  inline std::string get_name(flow_vertex_t v) {
-    std::string stack = FG->G[v].stack;
-    std::string name = stack.substr(0, stack.find("."));
-    return name;
-  }
+  // Only kept up to date by add and rewind. Like the parent sequence always
+  // was, it is left alone by remove and reverse.
+  llvm::SmallVector<ParentRun, 16> parents;
+  uint64_t parent_bits = 0;
 
-  inline bool is_return(flow_vertex_t v);
+  // Tokens of the calls output() shows, and the position in vertices of each.
+  // Filled on the first output() or has_output(), extended by add while the set
+  // of functions on the path stays the same, and dropped by everything else.
+  // Not copied with the path, which would allocate for the tokens; a copy
+  // fills its own on first use.
+  struct CallCache {
+    std::vector<std::string> tokens;
+    llvm::SmallVector<uint32_t, 16> positions;
+    bool valid = false;
 
-public:
-  // How can get this to be const?
-  // Requires keeping parent_sequence up to date somewhere else.
-  inline std::vector<std::string> get_parent_sequence() {
-    if (parents_valid) {
-      return parent_sequence;
+    CallCache() {}
+    CallCache(const CallCache &) {}
+    CallCache(CallCache &&) = default;
+    CallCache& operator=(const CallCache &) {
+      tokens.clear();
+      positions.clear();
+      valid = false;
+      return *this;
     }
+    CallCache& operator=(CallCache &&) = default;
+  };
+  CallCache calls;
 
-    parent_sequence.clear();
-    
-    for (const flow_vertex_t v : vertices) {
-      std::string stack = FG->G[v].stack;
-      std::string parent_fn = stack.substr(0, stack.find("."));      
-      if (parent_sequence.empty() || parent_sequence.back() != parent_fn) {
-        parent_sequence.push_back(parent_fn);
-      }
-    }
+  void push_output(flow_vertex_t v);
+  void cache_calls();
+  void cache_call(uint32_t pos);
+  void rebuild_signatures();
+  void push_parent(uint32_t fn, uint32_t start);
+  
+  // Prefer pointer over reference because we want to be able to put
+  // paths in containers. References are not assignable.
+  std::shared_ptr<const FlowGraph> FG;
+
+  std::string prefix;  
+
+  // Calls fn with every token of output()
+  template <typename Fn>
+  void for_each_output(Fn fn);
 
-    parents_valid = true;
+  bool in_parent_sequence(uint32_t fn) const;
+  bool is_output_call(flow_vertex_t v) const;
 
-    return parent_sequence;
+  static uint64_t parent_bit(uint32_t fn) {
+    return 1ull << (fn & 63);
   }
 };
 
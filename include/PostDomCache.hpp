@@ -0,0 +1,62 @@
+// Post-dominator trees of recently used functions.
+//
+// Hint resolution in tracegen and HandlersPass asks about the same function
+// once per branch, and each question used to rebuild that function's tree.
+// Trees are built on first use and kept while the estimated size of all cached
+// trees is within the budget. Past it the least recently used trees are
+// dropped, so the number of builds follows the number of distinct functions.
+
+#ifndef POSTDOMCACHE_HPP
+#define POSTDOMCACHE_HPP
+
+#include "llvm/Analysis/PostDominators.h"
+#include "llvm/IR/Function.h"
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+namespace ep {
+
+class PostDomCache {
+public:
+  static const size_t DEFAULT_BUDGET = 256 << 20;
+
+  explicit PostDomCache(size_t budget_bytes = DEFAULT_BUDGET) : budget(budget_bytes) {}
+
+  PostDomCache(const PostDomCache &) = delete;
+  PostDomCache& operator=(const PostDomCache &) = delete;
+
+  // Tree for F. Stays valid until get is called for another function.
+  llvm::PostDominatorTree& get(llvm::Function &F);
+
+  void clear();
+
+  size_t builds() const {
+    return num_builds;
+  }
+
+  size_t lookups() const {
+    return num_lookups;
+  }
+
+private:
+  struct Entry {
+    llvm::Function *F;
+    std::unique_ptr<llvm::PostDominatorTree> tree;
+    size_t bytes;
+  };
+
+  size_t budget;
+  size_t used = 0;
+  size_t num_builds = 0;
+  size_t num_lookups = 0;
+
+  // Most recently used first
+  std::list<Entry> lru;
+  std::unordered_map<llvm::Function*, std::list<Entry>::iterator> entries;
+};
+
+}
+
+#endif
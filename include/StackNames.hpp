@@ -0,0 +1,211 @@
+// Interned stack names.
+//
+// Every ICFG vertex is named by a stack location. Textually these look like
+//   foo.12      instruction 12 in function foo
+//   foo.12bbe   entry of the basic block whose first instruction is foo.12
+//   foo.12bbx   exit of that basic block
+//   foo.0       entry of function foo
+//   printf      anything else (external callees, unit tests)
+//
+// Building and comparing those strings dominated ICFG construction, so a stack
+// name is carried around as a 64-bit key instead:
+//
+//   | kind (2) | function id (30) | iid (32) |
+//
+// RAW keys hold a string id in the iid field. Function id 0 is never assigned,
+// so key 0 means "no stack name". The textual form is only produced by str().
+
+#ifndef STACKNAMES_HPP
+#define STACKNAMES_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+typedef uint64_t stack_key_t;
+
+enum class StackKind : uint64_t { INST = 0, BBE = 1, BBX = 2, RAW = 3 };
+
+// Interns strings to dense ids. Id 0 is always the empty string.
+class StringTable {
+public:
+  StringTable() {
+    intern("");
+  }
+
+  uint32_t intern(const std::string &s) {
+    auto it = ids.find(s);
+    if (it != ids.end()) {
+      return it->second;
+    }
+    uint32_t id = strings.size();
+    strings.push_back(s);
+    ids.insert(std::make_pair(s, id));
+    return id;
+  }
+
+  // Returns false if s was never interned
+  bool find(const std::string &s, uint32_t &id) const {
+    auto it = ids.find(s);
+    if (it == ids.end()) {
+      return false;
+    }
+    id = it->second;
+    return true;
+  }
+
+  const std::string& str(uint32_t id) const {
+    return strings[id];
+  }
+
+  uint32_t size() const {
+    return strings.size();
+  }
+
+private:
+  std::vector<std::string> strings;
+  std::unordered_map<std::string, uint32_t> ids;
+};
+
+class StackNameTable {
+public:
+  static const unsigned KIND_SHIFT = 62;
+  static const unsigned FUNCTION_SHIFT = 32;
+  static const uint64_t FUNCTION_MASK = (1ull << 30) - 1;
+  static const uint64_t IID_MASK = (1ull << 32) - 1;
+
+  static stack_key_t makeKey(StackKind kind, uint32_t fn, uint32_t iid) {
+    return (uint64_t) kind << KIND_SHIFT | ((uint64_t) fn & FUNCTION_MASK) << FUNCTION_SHIFT | iid;
+  }
+
+  static StackKind kind(stack_key_t key) {
+    return (StackKind) (key >> KIND_SHIFT);
+  }
+
+  static uint32_t function(stack_key_t key) {
+    return (key >> FUNCTION_SHIFT) & FUNCTION_MASK;
+  }
+
+  static uint32_t iid(stack_key_t key) {
+    return key & IID_MASK;
+  }
+
+  // Register a function name. Must happen before any stack name in that
+  // function is interned from a string, or the string will stay RAW.
+  uint32_t addFunction(const std::string &name) {
+    uint32_t id = functions.intern(name);
+    if (id > FUNCTION_MASK) {
+      std::cerr << "FATAL ERROR: Too many functions for StackNameTable\n";
+      abort();
+    }
+    return id;
+  }
+
+  // Key for an arbitrary stack string. Strings that have the structured form of
+  // a registered function get the same key as the structured constructor would.
+  stack_key_t intern(const std::string &stack) {
+    if (stack.empty()) {
+      return 0;
+    }
+    stack_key_t key;
+    if (parse(stack, key)) {
+      return key;
+    }
+    return makeKey(StackKind::RAW, 0, raw.intern(stack));
+  }
+
+  // Same as intern, but never adds to the table
+  // Returns 0 if the stack string was never interned
+  stack_key_t lookup(const std::string &stack) const {
+    stack_key_t key = 0;
+    uint32_t id;
+    if (stack.empty() || parse(stack, key)) {
+      return key;
+    }
+    if (raw.find(stack, id)) {
+      return makeKey(StackKind::RAW, 0, id);
+    }
+    return 0;
+  }
+
+  // Key of the function entry (foo.0) for any stack in foo
+  // Returns 0 for RAW stacks that do not belong to a registered function
+  stack_key_t entryKey(stack_key_t key) const {
+    if (kind(key) != StackKind::RAW) {
+      return makeKey(StackKind::INST, function(key), 0);
+    }
+    const std::string &stack = raw.str(iid(key));
+    return lookup(stack.substr(0, stack.find('.')) + ".0");
+  }
+
+  // Registered functions have ids 1 .. numFunctions() - 1, in registration order
+  uint32_t numFunctions() const {
+    return functions.size();
+  }
+
+  const std::string& functionName(uint32_t fn) const {
+    return functions.str(fn);
+  }
+
+  std::string str(stack_key_t key) const {
+    switch (kind(key)) {
+    case StackKind::RAW:
+      return raw.str(iid(key));
+    case StackKind::BBE:
+      return functions.str(function(key)) + "." + std::to_string(iid(key)) + "bbe";
+    case StackKind::BBX:
+      return functions.str(function(key)) + "." + std::to_string(iid(key)) + "bbx";
+    default:
+      return functions.str(function(key)) + "." + std::to_string(iid(key));
+    }
+  }
+
+private:
+  StringTable functions;
+  StringTable raw;
+
+  // Recognize fn.iid, fn.iidbbe and fn.iidbbx for registered functions.
+  // Only canonical iids (no leading zeros) are accepted so str(parse(s)) == s.
+  bool parse(const std::string &stack, stack_key_t &key) const {
+    StackKind k = StackKind::INST;
+    size_t end = stack.size();
+    if (end > 3 && stack.compare(end - 3, 3, "bbe") == 0) {
+      k = StackKind::BBE;
+      end -= 3;
+    } else if (end > 3 && stack.compare(end - 3, 3, "bbx") == 0) {
+      k = StackKind::BBX;
+      end -= 3;
+    }
+
+    size_t dot = stack.rfind('.', end);
+    if (dot == std::string::npos || dot == 0 || dot + 1 == end || end - dot - 1 > 10) {
+      return false;
+    }
+    if (stack[dot + 1] == '0' && end - dot - 1 > 1) {
+      return false;
+    }
+
+    uint64_t n = 0;
+    for (size_t i = dot + 1; i < end; ++i) {
+      if (stack[i] < '0' || stack[i] > '9') {
+        return false;
+      }
+      n = n * 10 + (stack[i] - '0');
+    }
+    if (n > IID_MASK) {
+      return false;
+    }
+
+    uint32_t fn;
+    if (!functions.find(stack.substr(0, dot), fn) || fn == 0) {
+      return false;
+    }
+    key = makeKey(k, fn, n);
+    return true;
+  }
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define UTILITY_HPP
 
 #include "Location.hpp"
+#include "VisitedEpochs.hpp"
 #include <llvm/IR/Instructions.h>
 #include <llvm/IR/DebugInfo.h>
 #include <boost/graph/adjacency_list.hpp>
@@ -12,6 +13,7 @@
 #include <iostream>
 #include <stack>
 #include <map>
+#include <vector>
 
 namespace p2v {
   std::unordered_set<std::string> read_interesting_functions(std::string path);
@@ -35,8 +37,29 @@ public:
   virtual bool follow_edge(const edge_t edge, const GraphT &G) const = 0;
 };
 
+// Dense index of a vertex, used by DepthFirstVisitor to keep its marks in
+// arrays. The default numbers vertices in the order they are first seen.
+// Graphs that carry their own numbering specialize it (see FlowGraph.hpp and
+// CompactFlowGraph.hpp).
+template<class GraphT>
+struct DenseVertexIndex {
+  typedef typename boost::graph_traits<GraphT>::vertex_descriptor vertex_t;
+
+  size_t operator()(vertex_t v, const GraphT &) {
+    return ids.insert(std::make_pair(v, ids.size())).first->second;
+  }
+
+private:
+  std::map<vertex_t, size_t> ids;
+};
+
 // BOOST dfs_visit cannot mutate the graph.
 // We commonly modify internal properties, so we relax that restriction here.
+//
+// Visited, on-path and between marks are epoch arrays indexed by
+// DenseVertexIndex. They belong to the thread and are reused by every search
+// on it, so starting a search does not touch every vertex. A visitor must not
+// start another search from discover_vertex.
 template<class GraphT>
 class DepthFirstVisitor {
   typedef typename boost::graph_traits<GraphT>::vertex_descriptor vertex_t;
@@ -44,11 +67,23 @@ class DepthFirstVisitor {
   typedef typename boost::graph_traits<GraphT>::out_edge_iterator oei_t;
 
 public:
-  DepthFirstVisitor(DFSVisitorInterface<GraphT> &visitor) : visitor(visitor) {}
+  // How visit(start, end, G) finds the vertices between
+  enum class Between {
+    // Forward reachable from start and backward reachable to end, found with
+    // one sweep each way. Linear in the edges followed.
+    SWEEP,
+    // Enumerate branches from start. Exponential in the worst case, kept to
+    // compare results against.
+    ENUMERATE
+  };
+
+  DepthFirstVisitor(DFSVisitorInterface<GraphT> &visitor, Between between = Between::SWEEP) :
+    visitor(visitor), between_engine(between) {}
 
   // Discover all nodes reachable from start vertex
   void visit(vertex_t start_vtx, GraphT &G) {
-    std::map<vertex_t, bool> visited;
+    Marks &marks = thread_marks();
+    marks.visited.reset();
     std::stack<vertex_t> pending;
     pending.push(start_vtx);
 
@@ -57,67 +92,161 @@ public:
       vertex_t next = pending.top();
       pending.pop();
 
-      if (visited.find(next) == visited.end()) {
+      size_t i = index(next, G);
+      if (!marked(marks.visited, i)) {
         visitor.discover_vertex(next, G);
+        mark(marks.visited, i);
       }
 
-      visited[next] = true;
-
-      for (std::tie(oei, oei_end) = boost::out_edges(next, G); oei != oei_end; ++oei) {
-        vertex_t v = boost::target(*oei, G);
-        if (visited.find(v) == visited.end() && visitor.follow_edge(*oei, G)) {
+      for (std::tie(oei, oei_end) = out_edges(next, G); oei != oei_end; ++oei) {
+        vertex_t v = target(*oei, G);
+        if (!marked(marks.visited, index(v, G)) && visitor.follow_edge(*oei, G)) {
           pending.push(v);
         }
       }
     }
   }
 
-  // Discover all nodes between start and end vertex (including start, but not including end)
-  // Does not preserve any order of discovery
-  // TODO: Convert visited map to something that can do the lookup faster
+  // Discover all nodes between start and end vertex, both included when end
+  // can be reached. Discovered in the order of their dense index.
   void visit(vertex_t start_vtx, vertex_t end_vtx, GraphT &G) {
-    if (!start_vtx || !end_vtx) {
+    const vertex_t null_vtx = boost::graph_traits<GraphT>::null_vertex();
+    if (start_vtx == null_vtx || end_vtx == null_vtx) {
       std::cerr << "FATAL ERROR: Cannot visit null vertex\n";
       abort();
     }
 
+    if (between_engine == Between::ENUMERATE) {
+      enumerate_between(start_vtx, end_vtx, G);
+    } else {
+      sweep_between(start_vtx, end_vtx, G);
+    }
+  }
+
+private:
+  // A vertex is between if a walk from start reaches it without passing
+  // through end, and a walk from it reaches end without passing through start.
+  // Needs in_edges, so GraphT must be bidirectional.
+  void sweep_between(vertex_t start_vtx, vertex_t end_vtx, GraphT &G) {
+    Marks &marks = thread_marks();
+    marks.visited.reset();
+    marks.between.reset();
+
+    std::vector<vertex_t> pending;
+    mark(marks.visited, index(start_vtx, G));
+    pending.push_back(start_vtx);
+    while (!pending.empty()) {
+      vertex_t next = pending.back();
+      pending.pop_back();
+      if (next == end_vtx) continue;
+
+      oei_t oei, oei_end;
+      for (std::tie(oei, oei_end) = out_edges(next, G); oei != oei_end; ++oei) {
+        vertex_t v = target(*oei, G);
+        size_t i = index(v, G);
+        if (!marked(marks.visited, i) && visitor.follow_edge(*oei, G)) {
+          mark(marks.visited, i);
+          pending.push_back(v);
+        }
+      }
+    }
+
+    std::vector<std::pair<size_t, vertex_t>> between;
+    size_t end_index = index(end_vtx, G);
+    if (!marked(marks.visited, end_index)) {
+      return;
+    }
+    mark(marks.between, end_index);
+    between.push_back(std::make_pair(end_index, end_vtx));
+    pending.push_back(end_vtx);
+    while (!pending.empty()) {
+      vertex_t next = pending.back();
+      pending.pop_back();
+      if (next == start_vtx) continue;
+
+      auto in_range = in_edges(next, G);
+      for (auto iei = in_range.first; iei != in_range.second; ++iei) {
+        vertex_t u = source(*iei, G);
+        size_t i = index(u, G);
+        // Only vertices the forward sweep reached can be between
+        if (marked(marks.visited, i) && !marked(marks.between, i) && visitor.follow_edge(*iei, G)) {
+          mark(marks.between, i);
+          between.push_back(std::make_pair(i, u));
+          pending.push_back(u);
+        }
+      }
+    }
+
+    discover_in_index_order(between, G);
+  }
+
+  // The path of a branch is the path of the vertex it branched from, so
+  // pending branches only record how deep that vertex was. Branches are taken
+  // last in first out, so the current path always extends the path of the
+  // next branch and can be cut back to it.
+  void enumerate_between(vertex_t start_vtx, vertex_t end_vtx, GraphT &G) {
+    struct Branch {
+      vertex_t vtx;
+      // Length of the path when the branch was taken
+      size_t depth;
+    };
+
+    Marks &marks = thread_marks();
+    marks.visited.reset();
+    marks.on_path.reset();
+    marks.between.reset();
+
     bool success = false;
-    std::vector<std::pair<vertex_t, std::set<vertex_t>>> pending_branches;
-    std::set<vertex_t> path;
-    std::map<vertex_t, bool> visited;
-    std::set<vertex_t> between;
+    std::vector<Branch> pending_branches;
+    std::vector<vertex_t> path;
+    std::vector<std::pair<size_t, vertex_t>> between;
 
-    std::function<void()> end_branch_fn = [&path, &success, &between, &pending_branches]() {
+    auto end_branch_fn = [&]() {
       if (success) {
-        between.insert(path.begin(), path.end());
+        // Below the last vertex every vertex on the path was expanded once,
+        // always with the same path before it. Once one of them is between,
+        // so is everything before it.
+        for (size_t k = path.size(); k-- > 0; ) {
+          size_t i = index(path[k], G);
+          if (marked(marks.between, i)) {
+            if (k + 1 < path.size()) break;
+            continue;
+          }
+          mark(marks.between, i);
+          between.push_back(std::make_pair(i, path[k]));
+        }
       }
       pending_branches.pop_back();
       success = false;
     };
 
-    pending_branches.push_back(std::make_pair(start_vtx, std::set<vertex_t>()));
-    
+    pending_branches.push_back(Branch{start_vtx, 0});
+
     bool chain_node = false;
     vertex_t next;
-    while (!pending_branches.empty() || chain_node) {     
+    while (!pending_branches.empty() || chain_node) {
       if (!chain_node) {
-        next = std::get<0>(pending_branches.back());
-        path = std::get<1>(pending_branches.back());
+        next = pending_branches.back().vtx;
+        while (path.size() > pending_branches.back().depth) {
+          marks.on_path.unmark(index(path.back(), G));
+          path.pop_back();
+        }
       }
 
-      bool next_between = between.find(next) != between.end();
+      size_t i = index(next, G);
+      bool next_between = marked(marks.between, i);
 
       // If we have already seen the vertex, skip if it wasn't successful
       // Even if it was successful, skip if it is in the current path
-      if ((visited.find(next) != visited.end() && !next_between) 
-          || path.find(next) != path.end()) {
+      if ((marked(marks.visited, i) && !next_between) || marked(marks.on_path, i)) {
         chain_node = false;
         end_branch_fn();
         continue;
       }
 
-      path.insert(next);
-      visited[next] = true;
+      path.push_back(next);
+      mark(marks.on_path, i);
+      mark(marks.visited, i);
 
       if (next == end_vtx || next_between) {
         chain_node = false;
@@ -127,13 +256,14 @@ public:
       }
 
       oei_t oei, oei_end;
-      if (follow_degree(next, G) == 0) {
+      unsigned degree = follow_degree(next, G);
+      if (degree == 0) {
         chain_node = false;
         end_branch_fn();
-      } else if (follow_degree(next, G) == 1) {
+      } else if (degree == 1) {
         chain_node = true;
-  
-        for (std::tie(oei, oei_end) = boost::out_edges(next, G); oei != oei_end; ++oei) {
+
+        for (std::tie(oei, oei_end) = out_edges(next, G); oei != oei_end; ++oei) {
           if (visitor.follow_edge(*oei, G)) {
             next = target(*oei, G);
             break;
@@ -141,25 +271,32 @@ public:
         }
       } else {
         chain_node = false;
-        for (std::tie(oei, oei_end) = boost::out_edges(next, G); oei != oei_end; ++oei) {
+        for (std::tie(oei, oei_end) = out_edges(next, G); oei != oei_end; ++oei) {
           if (visitor.follow_edge(*oei, G)) {
-            pending_branches.push_back(std::make_pair(target(*oei, G), path));
+            pending_branches.push_back(Branch{target(*oei, G), path.size()});
           }
         }
       }
     }
 
-    for (vertex_t v : between) {
-      visitor.discover_vertex(v, G);
+    discover_in_index_order(between, G);
+  }
+
+  void discover_in_index_order(std::vector<std::pair<size_t, vertex_t>> &between, GraphT &G) {
+    std::sort(between.begin(), between.end(),
+              [](const std::pair<size_t, vertex_t> &a, const std::pair<size_t, vertex_t> &b) {
+                return a.first < b.first;
+              });
+    for (const auto &b : between) {
+      visitor.discover_vertex(b.second, G);
     }
-  }  
+  }
 
-private:
   unsigned follow_degree(const vertex_t v, const GraphT &G) const {
     unsigned ret = 0;
 
     oei_t oei, oei_end;
-    for (std::tie(oei, oei_end) = boost::out_edges(v, G); oei != oei_end; ++oei) {
+    for (std::tie(oei, oei_end) = out_edges(v, G); oei != oei_end; ++oei) {
       if (visitor.follow_edge(*oei, G)) {
         ++ret;
       }
@@ -168,7 +305,31 @@ private:
     return ret;
   }
 
+  struct Marks {
+    VisitedEpochs visited;
+    VisitedEpochs on_path;
+    VisitedEpochs between;
+  };
+
+  static Marks& thread_marks() {
+    static thread_local Marks marks;
+    return marks;
+  }
+
+  static bool marked(const VisitedEpochs &marks, size_t i) {
+    return i < marks.size() && marks.visited(i);
+  }
+
+  static void mark(VisitedEpochs &marks, size_t i) {
+    if (i >= marks.size()) {
+      marks.resize(std::max(i + 1, 2 * marks.size()));
+    }
+    marks.mark(i);
+  }
+
   DFSVisitorInterface<GraphT> &visitor;
+  Between between_engine;
+  DenseVertexIndex<GraphT> index;
 };
 
 }
@@ -0,0 +1,56 @@
+// Visited marks that can all be cleared in O(1).
+//
+// Each slot holds the epoch in which it was last marked, and a slot counts as
+// visited only while that matches the current epoch. Starting a new search
+// bumps the epoch instead of sweeping every vertex. Slots are usually indexed
+// by FlowVertex::index.
+
+#ifndef VISITEDEPOCHS_HPP
+#define VISITEDEPOCHS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class VisitedEpochs {
+public:
+  explicit VisitedEpochs(size_t n = 0) : epochs(n, 0) {}
+
+  size_t size() const {
+    return epochs.size();
+  }
+
+  // New slots start unvisited
+  void resize(size_t n) {
+    epochs.resize(n, 0);
+  }
+
+  // Unmark everything. Only sweeps when the counter wraps around.
+  void reset() {
+    if (++current == 0) {
+      std::fill(epochs.begin(), epochs.end(), 0);
+      current = 1;
+    }
+  }
+
+  bool visited(size_t i) const {
+    return epochs[i] == current;
+  }
+
+  void mark(size_t i) {
+    epochs[i] = current;
+  }
+
+  void unmark(size_t i) {
+    epochs[i] = 0;
+  }
+
+private:
+  std::vector<uint32_t> epochs;
+
+  // Never 0, so unmarked slots never match
+  uint32_t current = 1;
+};
+
+#endif
@@ -1,43 +1,279 @@
 #include "Context.hpp"
 #include <boost/graph/graph_utility.hpp>
+#include "Parallel.hpp"
 #include <boost/progress.hpp>
+#include <cstdio>
+#include "Corpus.hpp"
 
 using namespace std;
 using namespace llvm;
 using namespace p2v;
 
+namespace {
+
+// Call sites per batch. Output of a batch is held until the whole batch is
+// done, then written in call site order.
+const size_t CALL_SITE_BATCH = 1024;
+
+// Bytes of batch output a worker keeps in memory before moving it to disk
+const size_t SPILL_THRESHOLD = 64 << 20;
+
+// Where the output of one call site went
+struct CallSiteOutput {
+  unsigned worker = 0;
+  size_t offset = 0;
+  size_t length = 0;
+};
+
+// Output of one worker for the current batch. Past SPILL_THRESHOLD bytes it
+// moves to an unnamed temporary file, so a call site with a huge number of
+// paths does not hold them all in memory.
+class SpillBuffer {
+public:
+  SpillBuffer() {}
+  SpillBuffer(const SpillBuffer &) = delete;
+  SpillBuffer& operator=(const SpillBuffer &) = delete;
+
+  ~SpillBuffer() {
+    if (file) {
+      fclose(file);
+    }
+  }
+
+  void append(const char *data, size_t n) {
+    mem.append(data, n);
+    if (mem.size() >= SPILL_THRESHOLD) {
+      spill();
+    }
+  }
+
+  size_t size() const {
+    return spilled + mem.size();
+  }
+
+  // Write bytes [offset, offset + length) to o
+  void copy(size_t offset, size_t length, ostream &o) {
+    if (offset < spilled) {
+      size_t n = min(length, spilled - offset);
+      if (fflush(file) != 0 || fseeko(file, offset, SEEK_SET) != 0) {
+        cerr << "FATAL ERROR: Could not read back spilled paths\n";
+        abort();
+      }
+      vector<char> chunk(min<size_t>(n, 1 << 20));
+      for (size_t done = 0; done < n; ) {
+        size_t want = min(chunk.size(), n - done);
+        if (fread(chunk.data(), 1, want, file) != want) {
+          cerr << "FATAL ERROR: Could not read back spilled paths\n";
+          abort();
+        }
+        o.write(chunk.data(), want);
+        done += want;
+      }
+      offset += n;
+      length -= n;
+    }
+    if (length) {
+      o.write(mem.data() + (offset - spilled), length);
+    }
+  }
+
+  // Forget the contents but keep the file for the next batch
+  void clear() {
+    mem.clear();
+    spilled = 0;
+  }
+
+private:
+  string mem;
+  FILE *file = nullptr;
+  // Bytes at the start of the contents that are in file
+  size_t spilled = 0;
+
+  void spill() {
+    if (!file) {
+      file = tmpfile();
+    }
+    if (!file || fseeko(file, spilled, SEEK_SET) != 0 ||
+        fwrite(mem.data(), 1, mem.size(), file) != mem.size()) {
+      cerr << "FATAL ERROR: Could not spill paths to a temporary file\n";
+      abort();
+    }
+    spilled += mem.size();
+    mem.clear();
+  }
+};
+
+// Paths in the PATH_BEGIN ... PATH_END text format
+class TextPathWriter : public PathSink {
+public:
+  explicit TextPathWriter(SpillBuffer &buf) : buf(buf) {}
+
+  void begin_path() override {
+    buf.append("PATH_BEGIN ", 11);
+  }
+
+  void token(const string &s) override {
+    buf.append(s.data(), s.size());
+    buf.append(" ", 1);
+  }
+
+  void end_path() override {
+    buf.append("PATH_END\n", 9);
+  }
+
+private:
+  SpillBuffer &buf;
+};
+
+// Paths as binary corpus sentences. Token ids are looked up in a cache of the
+// worker first, so the shared vocabulary is only locked for new tokens.
+class CorpusPathWriter : public PathSink {
+public:
+  CorpusPathWriter(SpillBuffer &buf, ep::CorpusVocabulary &vocab) : buf(buf), vocab(vocab) {}
+
+  void begin_path() override {
+    sentence.clear();
+  }
+
+  void token(const string &s) override {
+    auto it = ids.find(s);
+    if (it == ids.end()) {
+      it = ids.insert(make_pair(s, vocab.intern(s))).first;
+    }
+    sentence.push_back(it->second);
+  }
+
+  void end_path() override {
+    record.clear();
+    ep::append_sentence(record, sentence.data(), sentence.size());
+    buf.append(record.data(), record.size());
+  }
+
+private:
+  SpillBuffer &buf;
+  ep::CorpusVocabulary &vocab;
+  unordered_map<string, uint32_t> ids;
+  vector<uint32_t> sentence;
+  string record;
+};
+
+// Every token pathgen can write, interned in a fixed order before the search
+// so that ids do not depend on which worker saw a token first.
+void seed_vocabulary(ep::CorpusVocabulary &vocab, const FlowGraph &FG, const Llvm &passes,
+                     bool arg_callinfo, bool err_annotations, const string &return_str) {
+  // In vertex index order, as vertex iteration follows addresses
+  vector<flow_vertex_t> by_index(FG.num_indices(), nullptr);
+  BGL_FORALL_VERTICES(v, FG.G, _FlowGraph) {
+    by_index[FG.G[v].index] = v;
+  }
+  for (flow_vertex_t v : by_index) {
+    if (v && FG.is_call(v)) {
+      vocab.intern(FG.call_name(v));
+    }
+  }
+  if (arg_callinfo) {
+    for (uint32_t fn = 0; fn < FG.num_functions(); ++fn) {
+      vocab.intern("CALLER_" + FG.function_name(fn));
+    }
+  }
+  if (err_annotations) {
+    vocab.intern("RETURN_ERR");
+    vocab.intern("RETURN_NO_ERR");
+    vocab.intern("RETURN_" + return_str);
+    set<string> returning;
+    for (const auto &kv : passes.returning_functions_by_id) {
+      returning.insert(kv.second);
+    }
+    for (const string &fn : returning) {
+      vocab.intern("ERR_" + fn);
+      vocab.intern("NO_ERR_" + fn);
+    }
+  }
+}
+
+const string &find_or_empty(const map<string, string> &m, const string &key) {
+  static const string empty;
+  auto it = m.find(key);
+  return it == m.end() ? empty : it->second;
+}
+
+}
+
 // TODO: This list of parameters is getting out of hand. Make this a class already.
 void run_k_context_on_file(string bitcode_path, string interesting_path,
                            ostream &o, unsigned path_length, bool arg_callinfo,
-                           bool err_annotations, string return_str, string error_codes_path) {
-  RunMetrics metrics;
+                           bool err_annotations, string return_str, string error_codes_path,
+                           string cache_dir, unsigned threads, string vocab_path) {
   unordered_set<string> interesting = read_interesting_functions(interesting_path);
-  Llvm passes(bitcode_path, error_codes_path);
+  Llvm passes(bitcode_path, error_codes_path, false, threads, cache_dir);
   shared_ptr<FlowGraph> FG = passes.getFlowGraph();
 
-  vector<flow_vertex_t> call_sites = get_call_sites(*FG, interesting);  
+  // One entry per call edge to an interesting function, in graph order.
+  // The output is written in this order whatever the number of threads.
+  vector<flow_vertex_t> call_sites;
+  BGL_FORALL_VERTICES(v, FG->G, _FlowGraph) {
+    for (const uint32_t *callee = FG->callees_begin(v); callee != FG->callees_end(v); ++callee) {
+      if (interesting.find(FG->function_name(*callee)) == interesting.end()) continue;
+      call_sites.push_back(v);
+    }
+  }
+
+  threads = max(1u, (unsigned) min<size_t>(threads, call_sites.size()));
+  vector<SearchContext> contexts(threads, SearchContext(FG));
+  vector<SpillBuffer> buffers(threads);
+  vector<CallSiteOutput> outputs;
+
+  unique_ptr<ep::CorpusVocabulary> vocab;
+  vector<unique_ptr<PathSink>> sinks;
+  if (!vocab_path.empty()) {
+    vector<string> function_names;
+    for (uint32_t fn = 0; fn < FG->num_functions(); ++fn) {
+      function_names.push_back(FG->function_name(fn));
+    }
+    vocab.reset(new ep::CorpusVocabulary(passes.id_to_label, function_names));
+    seed_vocabulary(*vocab, *FG, passes, arg_callinfo, err_annotations, return_str);
+    o.write(ep::CORPUS_MAGIC, sizeof(ep::CORPUS_MAGIC));
+  }
+  for (SpillBuffer &buf : buffers) {
+    if (vocab) {
+      sinks.emplace_back(new CorpusPathWriter(buf, *vocab));
+    } else {
+      sinks.emplace_back(new TextPathWriter(buf));
+    }
+  }
 
   cerr << "Generating paths..." << endl;
-  boost::progress_display show_progress(num_vertices(FG->G), cerr);
-  BGL_FORALL_VERTICES(v, FG->G, _FlowGraph) {
-    ++show_progress;
-    BGL_FORALL_OUTEDGES(v, e, FG->G, _FlowGraph) {
-      if (!FG->G[e].call) continue;
-      string name = FG->G[target(e, FG->G)].stack;
-      name = name.substr(0, name.find("."));
-      if (interesting.find(name) == interesting.end()) continue;
-      
-      output_t paths = k_context(FG, v, path_length, metrics, arg_callinfo, err_annotations, passes, return_str);
-      for (const vector<string>& path : paths) {
-        assert(!path.empty());
-        
-        o << "PATH_BEGIN ";
-        for (const string& s : path) o << s << " ";
-        o << "PATH_END\n";
-      }
+  boost::progress_display show_progress(call_sites.size(), cerr);
+  for (size_t first = 0; first < call_sites.size(); first += CALL_SITE_BATCH) {
+    size_t n = min(CALL_SITE_BATCH, call_sites.size() - first);
+    outputs.assign(n, CallSiteOutput());
+    ep::parallel_for_worker(n, threads, [&](unsigned w, size_t i) {
+      SpillBuffer &buf = buffers[w];
+      outputs[i].worker = w;
+      outputs[i].offset = buf.size();
+      k_context(FG, call_sites[first + i], path_length, contexts[w],
+                arg_callinfo, err_annotations, passes, return_str, *sinks[w]);
+      outputs[i].length = buf.size() - outputs[i].offset;
+    });
+
+    for (const CallSiteOutput &out : outputs) {
+      buffers[out.worker].copy(out.offset, out.length, o);
+    }
+    for (SpillBuffer &buf : buffers) {
+      buf.clear();
     }
+    show_progress += n;
+  }
+
+  if (vocab && !vocab->write(vocab_path)) {
+    cerr << "FATAL ERROR: Could not write vocabulary to " << vocab_path << "\n";
+    abort();
   }
 
+  RunMetrics metrics;
+  for (const SearchContext &ctx : contexts) {
+    metrics.visit_threshold_hits += ctx.metrics.visit_threshold_hits;
+  }
   cerr << endl << "Metrics" << endl
        << "======" << endl
        << "Visit threshold hits: " << metrics.visit_threshold_hits << endl;
@@ -47,19 +283,17 @@ void run_k_context_on_file(string bitcode_path, string interesting_path,
 vector<flow_vertex_t> callers(flow_vertex_t v, const FlowGraph &FG) {
   vector<flow_vertex_t> ret;
   
-  string name = FG.G[v].stack;
-  name = name.substr(0, name.find("."));
-  name += ".0";
-
-  flow_vertex_t fn_entry = FG.stack_vertex_map.at(name);
+  flow_vertex_t fn_entry = FG.getVertex(FG.getStackNames().entryKey(FG.G[v].key));
+  if (!fn_entry) {
+    cerr << "FATAL ERROR: No function entry for " << FG.G[v].stack << "\n";
+    abort();
+  }
 
   BGL_FORALL_INEDGES(fn_entry, e, FG.G, _FlowGraph) {
     if (FG.G[e].call) {
-      flow_vertex_t call_site = source(e, FG.G);
-      BGL_FORALL_OUTEDGES(call_site, ret_e, FG.G, _FlowGraph) {
-        if (FG.G[ret_e].ret) {
-          ret.push_back(target(ret_e, FG.G));
-        }
+      flow_vertex_t return_site = FG.return_site(source(e, FG.G));
+      if (return_site) {
+        ret.push_back(return_site);
       }
     }
   }
@@ -67,71 +301,99 @@ vector<flow_vertex_t> callers(flow_vertex_t v, const FlowGraph &FG) {
   return ret;
 }
 
-output_t k_context(shared_ptr<FlowGraph> FG, flow_vertex_t start,
-                   unsigned path_length, RunMetrics &metrics, bool arg_callinfo,
-                   bool err_annotations, Llvm &passes, string return_str) {
-  paths_t forward  = __k_context(FG, start, path_length, true, metrics, passes);
-  paths_t backward = __k_context(FG, start, path_length, false, metrics, passes);
+PathJoinIndex::PathJoinIndex(paths_t &backward) {
+  for (size_t i = 0; i < backward.size(); ++i) {
+    vector<PathSignature> sigs = backward[i].parent_prefix_signatures();
+    if (sigs.empty()) continue;
+    whole[sigs.back()].push_back(i);
+    for (size_t j = 0; j + 1 < sigs.size(); ++j) {
+      prefixes[sigs[j]].push_back(i);
+    }
+  }
+}
+
+void PathJoinIndex::matches(Path &f, vector<size_t> &out) const {
+  out.clear();
+  vector<PathSignature> sigs = f.parent_prefix_signatures();
+  if (sigs.empty()) return;
+
+  // Backward sequences no longer than f's must be one of its prefixes
+  for (const PathSignature &sig : sigs) {
+    auto it = whole.find(sig);
+    if (it != whole.end()) {
+      out.insert(out.end(), it->second.begin(), it->second.end());
+    }
+  }
+  // Longer ones must start with all of f's
+  auto it = prefixes.find(sigs.back());
+  if (it != prefixes.end()) {
+    out.insert(out.end(), it->second.begin(), it->second.end());
+  }
+
+  std::sort(out.begin(), out.end());
+}
+
+void k_context(shared_ptr<FlowGraph> FG, flow_vertex_t start,
+               unsigned path_length, SearchContext &ctx, bool arg_callinfo,
+               bool err_annotations, const Llvm &passes, string return_str,
+               PathSink &sink) {
+  paths_t forward  = __k_context(FG, start, path_length, true, ctx, passes);
+  paths_t backward = __k_context(FG, start, path_length, false, ctx, passes);
   
-  unordered_set<string> seen_callsite_sequences;
+  PathSignatureSet seen_callsite_sequences;
+
+  PathJoinIndex index(backward);
+  vector<bool> b_has_output(backward.size());
+  for (size_t i = 0; i < backward.size(); ++i) {
+    b_has_output[i] = backward[i].has_output();
+  }
   
-  output_t ret;
+  vector<size_t> matches;
   for (Path &f : forward) {
-    vector<string> f_out = f.output();
-    if (f_out.size() == 0) continue;
-    
-    for (Path &b : backward) {            
-      if (!f.valid_match(b)) continue;
-
-      string callsites = f.get_callsite_sequence_idx() + b.get_callsite_sequence_idx();
-      if (seen_callsite_sequences.find(callsites) != seen_callsite_sequences.end()) {
+    if (!f.has_output()) continue;
+
+    index.matches(f, matches);
+    for (size_t i : matches) {
+      const Path &b = backward[i];
+#ifdef CHECK_PATH_SIGNATURES
+      assert(f.valid_match(backward[i]));
+#endif
+
+      PathSignature callsites = PathSignature::join(f.signature(), b.signature());
+      if (!seen_callsite_sequences.insert(callsites, [&]() {
+            return f.get_callsite_sequence_idx() + "|" + b.get_callsite_sequence_idx();
+          })) {
         continue;
-      } else {
-        seen_callsite_sequences.insert(callsites);
       }
       
-      vector<string> combined = b.output();      
-      if (combined.size() == 0) continue;
-
-      Path forward_back(b);
-      flow_vertex_t redundant = forward_back.get_vertices()[0];
-      forward_back.remove(redundant);
-      forward_back.reverse();            
-      for (const auto &v : f.get_vertices()) {
-        forward_back.add(v);
-      }
+      if (!b_has_output[i]) continue;
+
+      Path forward_back = Path::join(b, f);
            
       if (arg_callinfo) {
-        add_caller_paths(*FG, forward_back, ret);
+        add_caller_paths(*FG, forward_back, sink);
       }
       if (err_annotations) {
-        add_err_paths(*FG, forward_back, ret, passes, return_str);
+        add_err_paths(*FG, forward_back, sink, passes, return_str);
       }
 
-      if (! forward_back.output().empty()) {
-        ret.push_back(forward_back.output());
-      }
+      forward_back.output(sink);
     }
   }
-
-  return ret;
 }
 
 // Adds CALLER_ paths to path_list
-void add_caller_paths(const FlowGraph &FG, const Path &p, output_t &path_strings) {
+void add_caller_paths(const FlowGraph &FG, const Path &p, PathSink &sink) {
   for (const flow_vertex_t v : p.get_output_vertices()) {
-    vector<string> caller_path;
-    string stack = FG.G[v].stack;
-    string fname = stack.substr(0, stack.find('.'));
-    string call = "CALLER_" + fname;
-    caller_path.push_back(call);
-    caller_path.push_back(p.call_name(v));
-    path_strings.push_back(caller_path);
+    sink.begin_path();
+    sink.token("CALLER_" + FG.function_name(FG.function(v)));
+    sink.token(p.call_name(v));
+    sink.end_path();
   }
 }
 
 // Note that this mutates the path p to remove failed functions
-void add_err_paths(const FlowGraph &FG, Path &p, output_t &path_strings, Llvm &passes, string return_str) {
+void add_err_paths(const FlowGraph &FG, Path &p, PathSink &sink, const Llvm &passes, string return_str) {
   unordered_set<string> handlers_on, handlers_off, handlers_not;
   handlers_on = passes.handlers_on;
   handlers_off = passes.handlers_off;
@@ -146,19 +408,17 @@ void add_err_paths(const FlowGraph &FG, Path &p, output_t &path_strings, Llvm &p
   vector<string> no_err_path_for;
   bool empty_err = true;
 
-  vector<flow_vertex_t> path_vertices = p.get_vertices();
+  Path::vertices_t path_vertices = p.get_vertices();
 
   // Go through once and remove the error path vertices
   // This makes it much easier to keep track of things later
   // because we don't know if we should include a call in a branch until we see
   // which direction the path went.
   for (const flow_vertex_t v : path_vertices) {
-    string call_name = p.call_name(v);
     string id = FG.G[v].stack;
     if (handlers_on.find(id) != handlers_on.end()) {
-      string branch = passes.handler_to_branch[id];
-      string e = passes.returning_functions_by_id[branch];
-      p.remove_call(e);
+      const string &branch = find_or_empty(passes.handler_to_branch, id);
+      p.remove_call(find_or_empty(passes.returning_functions_by_id, branch));
     } 
   }
 
@@ -168,7 +428,7 @@ void add_err_paths(const FlowGraph &FG, Path &p, output_t &path_strings, Llvm &p
 
   path_vertices = p.get_vertices();
   for (const flow_vertex_t v : path_vertices) {
-    string call_name = p.call_name(v);
+    const string &call_name = p.call_name(v);
     string id = FG.G[v].stack;
 
     if (!call_name.empty()) {
@@ -178,18 +438,18 @@ void add_err_paths(const FlowGraph &FG, Path &p, output_t &path_strings, Llvm &p
     }
     
     if (handlers_on.find(id) != handlers_on.end()) {      
-      string branch = passes.handler_to_branch[id];
-      string fn = passes.returning_functions_by_id[branch];
+      const string &branch = find_or_empty(passes.handler_to_branch, id);
+      const string &fn = find_or_empty(passes.returning_functions_by_id, branch);
       if (!fn.empty()) {
-        err_path_for.push_back(passes.returning_functions_by_id[branch]);        
+        err_path_for.push_back(fn);        
       }
       p.handler_on.insert(v);
     }
     if (handlers_not.find(id) != handlers_not.end()) {
-      string branch = passes.handler_to_branch[id];
-      string fn = passes.returning_functions_by_id[branch];
+      const string &branch = find_or_empty(passes.handler_to_branch, id);
+      const string &fn = find_or_empty(passes.returning_functions_by_id, branch);
       if (!fn.empty()) {
-        no_err_path_for.push_back(passes.returning_functions_by_id[branch]);
+        no_err_path_for.push_back(fn);
       }
       p.no_handler_on.insert(v);
     }
@@ -197,27 +457,22 @@ void add_err_paths(const FlowGraph &FG, Path &p, output_t &path_strings, Llvm &p
       if (! call_name.empty()) {
         for (string &err_for : err_path_for) {
           empty_err = false;
-          vector<string> err_path;
-          string err = "ERR_";
-          err += err_for;
-          string call = p.call_name(v);
-          err_path.push_back(err);
-          err_path.push_back(call);
-          path_strings.push_back(err_path);
+          sink.begin_path();
+          sink.token("ERR_" + err_for);
+          sink.token(p.call_name(v));
+          sink.end_path();
         }
       }      
     }
     for (string &no_err_for : no_err_path_for) {
-      vector<string> no_err_path;
       bool call_is_err   = std::find(err_path_for.begin(), err_path_for.end(), call_name) != err_path_for.end();
       bool no_err_is_err = std::find(err_path_for.begin(), err_path_for.end(), no_err_for) != err_path_for.end();
       
       if (!call_name.empty() && !call_is_err && !no_err_is_err) {
-        string no_err = "NO_ERR_";
-        no_err += no_err_for;
-        no_err_path.push_back(no_err);
-        no_err_path.push_back(call_name);
-        path_strings.push_back(no_err_path);
+        sink.begin_path();
+        sink.token("NO_ERR_" + no_err_for);
+        sink.token(call_name);
+        sink.end_path();
         DEBUG_PRINT("Add NO_ERR_" + no_err_for + " " + call_name + "\n");
       }    
     }
@@ -225,11 +480,9 @@ void add_err_paths(const FlowGraph &FG, Path &p, output_t &path_strings, Llvm &p
 
   if (empty_err) {
     for (string &err_for : err_path_for) {
-      vector<string> err_path;
-      string err = "ERR_";
-      err += err_for;
-      err_path.push_back(err);
-      path_strings.push_back(err_path);      
+      sink.begin_path();
+      sink.token("ERR_" + err_for);
+      sink.end_path();
     }
   }
 
@@ -237,20 +490,27 @@ void add_err_paths(const FlowGraph &FG, Path &p, output_t &path_strings, Llvm &p
 }
 
 paths_t __k_context(shared_ptr<FlowGraph> FG, flow_vertex_t start,
-                    unsigned path_length, bool forward, RunMetrics &metrics,
-                    Llvm &passes) {
+                    unsigned path_length, bool forward, SearchContext &ctx,
+                    const Llvm &passes) {
   paths_t path_list; 
-  branches_t B;
-  Path path(FG);
+  branches_t &B = ctx.B;
+  VisitedEpochs &visited = ctx.visited;
+  visited.reset();
+  while (!B.empty()) {
+    B.pop();
+  }
+  Path &path = ctx.path;
+  path.clear();
  
-  unordered_set<string> seen_callsite_sequences;
+  PathSignatureSet seen_callsite_sequences;
+  auto callsites = [&]() { return path.get_callsite_sequence_idx(); };
   
-  if (!is_call(*FG, start)) {
+  if (!FG->is_call(start)) {
     return path_list;
   }
    
   path.add(start);
-  FG->G[start].visited = true;
+  visited.mark(FG->G[start].index);
 
   DEBUG_PRINT("__k_context " << forward << " " << FG->G[start].stack << endl);
 
@@ -292,7 +552,7 @@ paths_t __k_context(shared_ptr<FlowGraph> FG, flow_vertex_t start,
     }
     if (iterations > 1000 * path_length) {
       // Bail out on this call site entirely.
-      metrics.visit_threshold_hits += 1;
+      ctx.metrics.visit_threshold_hits += 1;
       break;
     }
 
@@ -307,14 +567,12 @@ paths_t __k_context(shared_ptr<FlowGraph> FG, flow_vertex_t start,
     // The branch stack is behind the tip of the path.
     // Remove the end of the path up to next branch and unmark nodes.
     if (path.needs_rewind(tail)) {
-      string callsites = path.get_callsite_sequence_idx();
-      if (seen_callsite_sequences.find(callsites) == seen_callsite_sequences.end()) {
-        seen_callsite_sequences.insert(callsites);
+      if (seen_callsite_sequences.insert(path.signature(), callsites)) {
         path_list.push_back(path);      
       }
 
       DEBUG_PRINT("rewind " << FG->G[tail].stack << endl);
-      path.rewind(tail);
+      path.rewind(tail, visited);
     }
 
     flow_vertex_t next;
@@ -324,13 +582,13 @@ paths_t __k_context(shared_ptr<FlowGraph> FG, flow_vertex_t start,
       next = source(b, FG->G);
     } 
 
-    if (FG->G[next].visited) {
+    if (visited.visited(FG->G[next].index)) {
       DEBUG_PRINT("already visited" << endl);
       continue;
     }
 
     path.add(next);
-    FG->G[next].visited = true;
+    visited.mark(FG->G[next].index);
     DEBUG_PRINT(FG->G[next].stack << endl);
 
     if (forward) {
@@ -350,12 +608,7 @@ paths_t __k_context(shared_ptr<FlowGraph> FG, flow_vertex_t start,
 
   // Append last path
   if (!path.empty()) {
-    for (const flow_vertex_t v : path.get_vertices()) {
-      FG->G[v].visited = false;
-    }
-
-    string callsites = path.get_callsite_sequence_idx();
-    if (seen_callsite_sequences.find(callsites) == seen_callsite_sequences.end()) {
+    if (!seen_callsite_sequences.contains(path.signature(), callsites)) {
       path_list.push_back(path);
     }
   }
@@ -367,11 +620,8 @@ vector<flow_vertex_t> get_call_sites(FlowGraph &FG, const unordered_set<string>
   unordered_set<flow_vertex_t> unique_sites;
 
   BGL_FORALL_VERTICES(v, FG.G, _FlowGraph) {
-    BGL_FORALL_OUTEDGES(v, e, FG.G, _FlowGraph) {
-      if (!FG.G[e].call) continue;
-      string name = FG.G[target(e, FG.G)].stack;
-      name = name.substr(0, name.find("."));
-      if (functions.find(name) != functions.end()) {
+    for (const uint32_t *callee = FG.callees_begin(v); callee != FG.callees_end(v); ++callee) {
+      if (functions.find(FG.function_name(*callee)) != functions.end()) {
         unique_sites.insert(v);
       }
     }
@@ -0,0 +1,138 @@
+#include "Corpus.hpp"
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+
+using namespace std;
+
+namespace ep {
+
+CorpusVocabulary::CorpusVocabulary(const unordered_map<int, string> &id_to_label,
+                                   const vector<string> &function_names) {
+  int num_labels = 0;
+  for (const auto &kv : id_to_label) {
+    num_labels = max(num_labels, kv.first + 1);
+  }
+  tokens.resize(num_labels);
+  for (int id = 0; id < num_labels; ++id) {
+    auto it = id_to_label.find(id);
+    tokens[id] = it == id_to_label.end() ? "F2V_UNUSED_" + to_string(id) : it->second;
+    ids.insert(make_pair(tokens[id], (uint32_t) id));
+  }
+  for (const string &name : function_names) {
+    intern(name);
+  }
+}
+
+uint32_t CorpusVocabulary::intern(const string &token) {
+  lock_guard<mutex> lock(m);
+  auto it = ids.find(token);
+  if (it != ids.end()) {
+    return it->second;
+  }
+  uint32_t id = tokens.size();
+  tokens.push_back(token);
+  ids.insert(make_pair(token, id));
+  return id;
+}
+
+size_t CorpusVocabulary::size() const {
+  lock_guard<mutex> lock(m);
+  return tokens.size();
+}
+
+bool CorpusVocabulary::write(const string &path) const {
+  lock_guard<mutex> lock(m);
+  ofstream out(path);
+  for (const string &token : tokens) {
+    out << token << '\n';
+  }
+  out.flush();
+  return out.good();
+}
+
+CorpusReader::CorpusReader(const string &path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(CORPUS_MAGIC)) {
+    close(fd);
+    return;
+  }
+  void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED) {
+    return;
+  }
+  if (memcmp(p, CORPUS_MAGIC, sizeof(CORPUS_MAGIC)) != 0) {
+    munmap(p, st.st_size);
+    return;
+  }
+  madvise(p, st.st_size, MADV_SEQUENTIAL);
+  mapped = st.st_size;
+  data = static_cast<const uint8_t*>(p);
+  end = data + mapped;
+  rewind();
+}
+
+CorpusReader::~CorpusReader() {
+  if (data) {
+    munmap(const_cast<uint8_t*>(data), mapped);
+  }
+}
+
+void CorpusReader::rewind() {
+  pos = data + sizeof(CORPUS_MAGIC);
+}
+
+bool CorpusReader::read_varint(uint64_t &v) {
+  v = 0;
+  for (unsigned shift = 0; pos < end && shift < 64; shift += 7) {
+    uint8_t byte = *pos++;
+    v |= (uint64_t) (byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool CorpusReader::next(vector<uint32_t> &ids) {
+  ids.clear();
+  if (!data || pos >= end) {
+    return false;
+  }
+  uint64_t n;
+  if (!read_varint(n) || n > (uint64_t) (end - pos)) {
+    return false;
+  }
+  ids.reserve(n);
+  for (uint64_t i = 0; i < n; ++i) {
+    uint64_t id;
+    if (!read_varint(id) || id > UINT32_MAX) {
+      return false;
+    }
+    ids.push_back(id);
+  }
+  return true;
+}
+
+bool read_vocabulary(const string &path, vector<string> &tokens) {
+  tokens.clear();
+  ifstream in(path);
+  if (!in) {
+    return false;
+  }
+  string line;
+  while (getline(in, line)) {
+    tokens.push_back(line);
+  }
+  return true;
+}
+
+}
@@ -0,0 +1,471 @@
+#include "GraphCache.hpp"
+#include "CompactFlowGraph.hpp"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <unistd.h>
+
+using namespace llvm;
+using namespace std;
+
+namespace p2v {
+
+namespace {
+
+const char GRAPH_CACHE_MAGIC[8] = {'F', '2', 'V', 'I', 'C', 'F', 'G', '\0'};
+
+struct CacheHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t num_vertices;
+};
+
+// Fixed-size records. Strings are ids into the string section.
+struct CachedVertex {
+  uint32_t stack;
+  uint32_t function;   // index + 1 into the function section, 0 for none
+  uint32_t file;
+  uint32_t line;
+  uint32_t mem_name;
+  uint32_t mem_base;
+  uint32_t mem_idx1;
+  uint32_t mem_idx2;
+  uint32_t mem_scope;
+  uint32_t flags;
+};
+
+const uint32_t VERTEX_HAS_INSTRUCTION = 1;
+const uint32_t VERTEX_HAS_MEM_INDEX = 2;
+
+struct CachedEdge {
+  uint32_t src;
+  uint32_t dst;
+  uint32_t kind;
+};
+
+struct CachedLabel {
+  int32_t id;
+  uint32_t label;
+};
+
+struct CachedPair {
+  uint32_t first;
+  uint32_t second;
+};
+
+// Appends sections to a byte buffer. Every section is a uint64_t element count
+// followed by the elements, padded to 8 bytes.
+class CacheWriter {
+public:
+  template <typename T>
+  void raw(const T &value) {
+    buf.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  template <typename T>
+  void section(const vector<T> &elements) {
+    raw<uint64_t>(elements.size());
+    if (!elements.empty()) {
+      buf.append(reinterpret_cast<const char*>(elements.data()), elements.size() * sizeof(T));
+    }
+    buf.append((8 - buf.size() % 8) % 8, '\0');
+  }
+
+  uint32_t str(const string &s) {
+    return strings.intern(s);
+  }
+
+  // The string section is written last but read first, so it goes in front
+  string finish(const CacheHeader &header) {
+    CacheWriter out;
+    out.raw(header);
+    vector<uint64_t> offsets;
+    string chars;
+    offsets.push_back(0);
+    for (uint32_t i = 0; i < strings.size(); ++i) {
+      chars += strings.str(i);
+      offsets.push_back(chars.size());
+    }
+    out.section(offsets);
+    out.section(vector<char>(chars.begin(), chars.end()));
+    return out.buf + buf;
+  }
+
+private:
+  string buf;
+  StringTable strings;
+};
+
+// Reads sections back in the order they were written. Element arrays are used
+// in place, so every read checks bounds and alignment. Any failure makes the
+// whole read fail.
+class CacheReader {
+public:
+  CacheReader(const char *begin, const char *end) : p(begin), end(end) {}
+
+  template <typename T>
+  bool raw(T &value) {
+    if (end - p < (ptrdiff_t) sizeof(T)) {
+      return false;
+    }
+    memcpy(&value, p, sizeof(T));
+    p += sizeof(T);
+    return true;
+  }
+
+  template <typename T>
+  bool section(const T *&elements, uint64_t &count) {
+    if (!raw(count) || count > (uint64_t) (end - p) / sizeof(T)) {
+      return false;
+    }
+    if (reinterpret_cast<uintptr_t>(p) % alignof(T) != 0) {
+      return false;
+    }
+    elements = reinterpret_cast<const T*>(p);
+    size_t size = count * sizeof(T);
+    size += (8 - size % 8) % 8;
+    if ((uint64_t) (end - p) < size) {
+      return false;
+    }
+    p += size;
+    return true;
+  }
+
+  bool strings() {
+    const uint64_t *offsets;
+    const char *chars;
+    uint64_t num_offsets, num_chars;
+    if (!section(offsets, num_offsets) || !section(chars, num_chars) || num_offsets == 0) {
+      return false;
+    }
+    table.reserve(num_offsets - 1);
+    for (uint64_t i = 0; i + 1 < num_offsets; ++i) {
+      if (offsets[i] > offsets[i + 1] || offsets[i + 1] > num_chars) {
+        return false;
+      }
+      table.push_back(string(chars + offsets[i], offsets[i + 1] - offsets[i]));
+    }
+    return true;
+  }
+
+  bool str(uint32_t id, string &s) const {
+    if (id >= table.size()) {
+      return false;
+    }
+    s = table[id];
+    return true;
+  }
+
+private:
+  const char *p;
+  const char *end;
+  vector<string> table;
+};
+
+bool hash_file(MD5 &hash, const string &path) {
+  ErrorOr<unique_ptr<MemoryBuffer>> buffer = MemoryBuffer::getFile(path);
+  if (!buffer) {
+    return false;
+  }
+  hash.update((*buffer)->getBuffer());
+  return true;
+}
+
+}
+
+string graph_cache_path(const string &cache_dir, const string &bitcode_path,
+                        const string &ec_path, bool remove_cross_folder) {
+  MD5 hash;
+  hash.update(StringRef(GRAPH_CACHE_MAGIC, sizeof(GRAPH_CACHE_MAGIC)));
+  hash.update(to_string(GRAPH_CACHE_VERSION));
+  if (!hash_file(hash, bitcode_path)) {
+    return "";
+  }
+  hash.update(StringRef("\0", 1));
+  if (!ec_path.empty() && !hash_file(hash, ec_path)) {
+    return "";
+  }
+  hash.update(remove_cross_folder ? "remove-cross-folder" : "");
+
+  MD5::MD5Result result;
+  hash.final(result);
+  SmallString<32> hex;
+  MD5::stringifyResult(result, hex);
+  return cache_dir + "/" + hex.str().str() + ".icfg";
+}
+
+bool write_graph_cache(const string &path, const FlowGraph &FG, const GraphCacheMeta &meta) {
+  const _FlowGraph &G = FG.G;
+  CacheWriter writer;
+
+  // Registered function names, so the reader rebuilds identical stack keys
+  const StackNameTable &stack_names = FG.getStackNames();
+  vector<uint32_t> registered;
+  for (uint32_t fn = 1; fn < stack_names.numFunctions(); ++fn) {
+    registered.push_back(writer.str(stack_names.functionName(fn)));
+  }
+
+  vector<flow_vertex_t> by_index(FG.num_indices(), nullptr);
+  BGL_FORALL_VERTICES(v, G, _FlowGraph) {
+    by_index[G[v].index] = v;
+  }
+
+  vector<CachedVertex> cached_vertices(by_index.size(), CachedVertex());
+  vector<uint32_t> vertex_functions;
+  unordered_map<const Function*, uint32_t> function_ids;
+  vector<uint32_t> label_offsets;
+  vector<int32_t> labels;
+  label_offsets.push_back(0);
+  for (size_t i = 0; i < by_index.size(); ++i) {
+    flow_vertex_t v = by_index[i];
+    if (!v) {
+      cerr << "FATAL ERROR: write_graph_cache found a gap in the vertex indices\n";
+      abort();
+    }
+    const FlowVertex &fv = G[v];
+    CachedVertex &cv = cached_vertices[i];
+    cv.stack = writer.str(fv.stack);
+    cv.file = writer.str(fv.loc.file);
+    cv.line = fv.loc.line;
+    if (fv.F) {
+      auto it = function_ids.find(fv.F);
+      if (it == function_ids.end()) {
+        vertex_functions.push_back(writer.str(fv.F->getName().str()));
+        it = function_ids.insert(make_pair(fv.F, (uint32_t) vertex_functions.size())).first;
+      }
+      cv.function = it->second;
+    }
+    if (fv.I) {
+      cv.flags |= VERTEX_HAS_INSTRUCTION;
+    }
+    if (fv.mem_index) {
+      cv.flags |= VERTEX_HAS_MEM_INDEX;
+      cv.mem_name = writer.str(fv.mem_index->name());
+      cv.mem_base = writer.str(fv.mem_index->base_name);
+      cv.mem_idx1 = fv.mem_index->idx1;
+      cv.mem_idx2 = fv.mem_index->idx2;
+      cv.mem_scope = (uint32_t) fv.mem_index->scope;
+    }
+    labels.insert(labels.end(), fv.label_ids.begin(), fv.label_ids.end());
+    label_offsets.push_back(labels.size());
+  }
+
+  vector<CachedEdge> cached_edges;
+  cached_edges.reserve(boost::num_edges(G));
+  BGL_FORALL_EDGES(e, G, _FlowGraph) {
+    cached_edges.push_back(CachedEdge{G[boost::source(e, G)].index, G[boost::target(e, G)].index,
+                               CompactFlowGraph::pack_kind(G[e])});
+  }
+
+  vector<CachedLabel> id_to_label;
+  for (const auto &kv : meta.id_to_label) {
+    id_to_label.push_back(CachedLabel{kv.first, writer.str(kv.second)});
+  }
+
+  vector<CachedPair> bootstrap;
+  for (const auto &kv : meta.bootstrap_fns) {
+    for (const string &fn : kv.second) {
+      bootstrap.push_back(CachedPair{writer.str(kv.first), writer.str(fn)});
+    }
+  }
+
+  writer.section(registered);
+  writer.section(vertex_functions);
+  writer.section(cached_vertices);
+  writer.section(label_offsets);
+  writer.section(labels);
+  writer.section(cached_edges);
+  writer.section(id_to_label);
+  writer.section(bootstrap);
+  writer.section(vector<uint64_t>(1, meta.cross_folder_pruned));
+
+  CacheHeader header;
+  memcpy(header.magic, GRAPH_CACHE_MAGIC, sizeof(header.magic));
+  header.version = GRAPH_CACHE_VERSION;
+  header.num_vertices = cached_vertices.size();
+  string contents = writer.finish(header);
+
+  // Write to a private file and rename, so readers never see a partial cache
+  string tmp_path = path + ".tmp." + to_string(getpid());
+  ofstream out(tmp_path, ios::binary);
+  out.write(contents.data(), contents.size());
+  out.close();
+  if (!out || rename(tmp_path.c_str(), path.c_str()) != 0) {
+    remove(tmp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+unique_ptr<FlowGraph> read_graph_cache(const string &path, GraphCacheMeta &meta) {
+  ErrorOr<unique_ptr<MemoryBuffer>> buffer = MemoryBuffer::getFile(path);
+  if (!buffer) {
+    return nullptr;
+  }
+  CacheReader reader((*buffer)->getBufferStart(), (*buffer)->getBufferEnd());
+
+  CacheHeader header;
+  if (!reader.raw(header) || memcmp(header.magic, GRAPH_CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version != GRAPH_CACHE_VERSION || !reader.strings()) {
+    return nullptr;
+  }
+
+  const uint32_t *registered, *vertex_functions, *label_offsets;
+  const int32_t *labels;
+  const CachedVertex *cached_vertices;
+  const CachedEdge *cached_edges;
+  const CachedLabel *id_to_label;
+  const CachedPair *bootstrap;
+  uint64_t num_registered, num_functions, num_vertices, num_offsets, num_labels, num_edges;
+  uint64_t num_id_to_label, num_bootstrap;
+  if (!reader.section(registered, num_registered) ||
+      !reader.section(vertex_functions, num_functions) ||
+      !reader.section(cached_vertices, num_vertices) ||
+      !reader.section(label_offsets, num_offsets) ||
+      !reader.section(labels, num_labels) ||
+      !reader.section(cached_edges, num_edges) ||
+      !reader.section(id_to_label, num_id_to_label) ||
+      !reader.section(bootstrap, num_bootstrap) ||
+      num_vertices != header.num_vertices || num_offsets != num_vertices + 1) {
+    return nullptr;
+  }
+
+  GraphCacheMeta loaded;
+  const uint64_t *metrics;
+  uint64_t num_metrics;
+  if (!reader.section(metrics, num_metrics) || num_metrics != 1) {
+    return nullptr;
+  }
+  loaded.cross_folder_pruned = metrics[0];
+
+  shared_ptr<StackNameTable> stack_names = make_shared<StackNameTable>();
+  for (uint64_t i = 0; i < num_registered; ++i) {
+    string name;
+    if (!reader.str(registered[i], name)) {
+      return nullptr;
+    }
+    stack_names->addFunction(name);
+  }
+
+  loaded.function_names.push_back("");
+  for (uint64_t i = 0; i < num_functions; ++i) {
+    string name;
+    if (!reader.str(vertex_functions[i], name)) {
+      return nullptr;
+    }
+    loaded.function_names.push_back(name);
+  }
+
+  unique_ptr<FlowGraph> FG(new FlowGraph());
+  FG->setStackNames(stack_names);
+  _FlowGraph &G = FG->G;
+
+  // Adding in index order gives every vertex its original index
+  vector<flow_vertex_t> by_index(num_vertices);
+  loaded.vertex_function.resize(num_vertices);
+  loaded.vertex_has_instruction.resize(num_vertices);
+  for (uint64_t i = 0; i < num_vertices; ++i) {
+    const CachedVertex &cv = cached_vertices[i];
+    string stack, file;
+    if (!reader.str(cv.stack, stack) || !reader.str(cv.file, file) ||
+        cv.function > num_functions || label_offsets[i] > label_offsets[i + 1] ||
+        label_offsets[i + 1] > num_labels) {
+      return nullptr;
+    }
+
+    FlowVertex fv(stack, Location(file, cv.line), nullptr);
+    fv.label_ids.assign(labels + label_offsets[i], labels + label_offsets[i + 1]);
+    if (cv.flags & VERTEX_HAS_MEM_INDEX) {
+      string mem_name, mem_base;
+      if (!reader.str(cv.mem_name, mem_name) || !reader.str(cv.mem_base, mem_base)) {
+        return nullptr;
+      }
+      fv.mem_index = make_shared<MemoryName>(mem_base, cv.mem_idx1, cv.mem_idx2,
+                                             (VarScope) cv.mem_scope, nullptr);
+      fv.mem_index->setName(mem_name);
+    }
+
+    flow_vertex_t v = FG->find_or_add_vertex(fv);
+    if (G[v].index != i) {
+      return nullptr;
+    }
+    unsigned index = G[v].index;
+    stack_key_t key = G[v].key;
+    G[v] = fv;
+    G[v].index = index;
+    G[v].key = key;
+    by_index[i] = v;
+    loaded.vertex_function[i] = cv.function;
+    loaded.vertex_has_instruction[i] = cv.flags & VERTEX_HAS_INSTRUCTION;
+  }
+
+  for (uint64_t i = 0; i < num_edges; ++i) {
+    const CachedEdge &ce = cached_edges[i];
+    if (ce.src >= num_vertices || ce.dst >= num_vertices) {
+      return nullptr;
+    }
+    flow_edge_t e;
+    tie(e, std::ignore) = boost::add_edge(by_index[ce.src], by_index[ce.dst], G);
+    CompactEdgeRef kind(ce.kind);
+    G[e].call = kind.call;
+    G[e].ret = kind.ret;
+    G[e].may_ret = kind.may_ret;
+    G[e].main = kind.main;
+  }
+
+  for (uint64_t i = 0; i < num_id_to_label; ++i) {
+    string label;
+    if (!reader.str(id_to_label[i].label, label)) {
+      return nullptr;
+    }
+    loaded.id_to_label[id_to_label[i].id] = label;
+  }
+
+  for (uint64_t i = 0; i < num_bootstrap; ++i) {
+    string group, fn;
+    if (!reader.str(bootstrap[i].first, group) || !reader.str(bootstrap[i].second, fn)) {
+      return nullptr;
+    }
+    loaded.bootstrap_fns[group].insert(fn);
+  }
+
+  FG->finalize();
+  meta = std::move(loaded);
+  return FG;
+}
+
+void bind_graph_to_module(FlowGraph &FG, Module &M, NamesPass &names, const GraphCacheMeta &meta) {
+  _FlowGraph &G = FG.G;
+
+  vector<Function*> functions;
+  for (const string &name : meta.function_names) {
+    functions.push_back(name.empty() ? nullptr : M.getFunction(name));
+  }
+
+  BGL_FORALL_VERTICES(v, G, _FlowGraph) {
+    if (G[v].index < meta.vertex_function.size()) {
+      G[v].F = functions[meta.vertex_function[G[v].index]];
+    }
+  }
+
+  // Instruction vertices are named by the same stack keys NamesPass hands out
+  for (Function &F : M) {
+    if (F.isIntrinsic() || F.isDeclaration()) {
+      continue;
+    }
+    for (BasicBlock &BB : F) {
+      for (Instruction &I : BB) {
+        flow_vertex_t v = FG.getVertex(names.getStackKey(I));
+        if (v && G[v].index < meta.vertex_has_instruction.size() &&
+            meta.vertex_has_instruction[G[v].index]) {
+          G[v].I = &I;
+        }
+      }
+    }
+  }
+}
+
+}
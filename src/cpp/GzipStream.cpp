@@ -0,0 +1,86 @@
+#include "GzipStream.hpp"
+#include <cstring>
+
+using namespace std;
+
+namespace ep {
+
+namespace {
+
+const size_t GZIP_CHUNK = 1 << 18;
+
+// windowBits + 16 makes deflate write a gzip header and trailer
+const int GZIP_WINDOW_BITS = 15 + 16;
+
+}
+
+GzipStreamBuf::GzipStreamBuf(ostream &out, int level) :
+  out(out), in(GZIP_CHUNK), compressed(GZIP_CHUNK) {
+  memset(&zs, 0, sizeof(zs));
+  if (deflateInit2(&zs, level, Z_DEFLATED, GZIP_WINDOW_BITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+    ok = false;
+    finished = true;
+  }
+  setp(in.data(), in.data() + in.size());
+}
+
+GzipStreamBuf::~GzipStreamBuf() {
+  finish();
+}
+
+bool GzipStreamBuf::deflate_pending(int flush) {
+  zs.next_in = reinterpret_cast<Bytef*>(pbase());
+  zs.avail_in = pptr() - pbase();
+  do {
+    zs.next_out = reinterpret_cast<Bytef*>(compressed.data());
+    zs.avail_out = compressed.size();
+    int ret = deflate(&zs, flush);
+    if (ret == Z_STREAM_ERROR) {
+      return false;
+    }
+    out.write(compressed.data(), compressed.size() - zs.avail_out);
+  } while (zs.avail_out == 0);
+  setp(in.data(), in.data() + in.size());
+  return out.good();
+}
+
+GzipStreamBuf::int_type GzipStreamBuf::overflow(int_type c) {
+  if (finished || !deflate_pending(Z_NO_FLUSH)) {
+    ok = false;
+    return traits_type::eof();
+  }
+  if (!traits_type::eq_int_type(c, traits_type::eof())) {
+    *pptr() = traits_type::to_char_type(c);
+    pbump(1);
+  }
+  return traits_type::not_eof(c);
+}
+
+int GzipStreamBuf::sync() {
+  // Only hand finished blocks to out. A full flush here would hurt the
+  // compression ratio every time the owner flushes.
+  if (finished) {
+    return ok ? 0 : -1;
+  }
+  if (!deflate_pending(Z_NO_FLUSH)) {
+    ok = false;
+    return -1;
+  }
+  out.flush();
+  return 0;
+}
+
+bool GzipStreamBuf::finish() {
+  if (finished) {
+    return ok;
+  }
+  finished = true;
+  if (!deflate_pending(Z_FINISH)) {
+    ok = false;
+  }
+  deflateEnd(&zs);
+  out.flush();
+  return ok && out.good();
+}
+
+}
@@ -1,6 +1,7 @@
 #include "Llvm.hpp"
 #include "BranchSafety.hpp"
 #include "HandlersPass.hpp"
+#include "GraphCache.hpp"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/IRReader/IRReader.h"
 #include "llvm/Analysis/MemoryDependenceAnalysis.h"
@@ -9,7 +10,26 @@ using namespace llvm;
 
 namespace p2v {
 
-  Llvm::Llvm(string bitcode_path, string ec_path, bool remove_cross_folder) {
+  Llvm::Llvm(string bitcode_path, string ec_path, bool remove_cross_folder, unsigned cfg_threads,
+             string cache_dir) {
+    string cache_path;
+    if (!cache_dir.empty()) {
+      cache_path = graph_cache_path(cache_dir, bitcode_path, ec_path, remove_cross_folder);
+    }
+
+    GraphCacheMeta meta;
+    if (!cache_path.empty()) {
+      unique_ptr<FlowGraph> cached = read_graph_cache(cache_path, meta);
+      if (cached) {
+        FG = std::move(cached);
+        id_to_label = std::move(meta.id_to_label);
+        bootstrap_fns = std::move(meta.bootstrap_fns);
+        cross_folder_pruned = meta.cross_folder_pruned;
+        loaded_from_cache = true;
+        return;
+      }
+    }
+
     SMDiagnostic Err;
     unique_ptr<Module> Mod(parseIRFile(bitcode_path, Err, getGlobalContext()));
     if (!Mod) {
@@ -25,26 +45,44 @@ namespace p2v {
     NamesPass *names = new NamesPass(ec_path);
     ControlFlowPass *cfp = new ControlFlowPass();
     cfp->remove_cross_folder = remove_cross_folder;
+    cfp->threads = cfg_threads;
     InstructionLabelsPass *ilp = new InstructionLabelsPass();
     PM.add(names);
     PM.add(cfp);
     PM.add(ilp);
     PM.run(*Mod);
 
-    // TODO: move instead of copy
-    FG = make_shared<FlowGraph>(cfp->FG);
+    // Take the graph from the pass instead of copying it
+    FG = cfp->releaseFlowGraph();
     bootstrap_fns = names->get_bootstrap_functions();
+    cross_folder_pruned = cfp->cross_folder_pruned;
 
     for (const auto &kv : ilp->label_to_id) {
       bool ok = id_to_label.insert({kv.second, kv.first}).second;
       assert(ok);
     }
+
+    if (!cache_path.empty()) {
+      meta.id_to_label = id_to_label;
+      meta.bootstrap_fns = bootstrap_fns;
+      meta.cross_folder_pruned = cross_folder_pruned;
+      if (!write_graph_cache(cache_path, *FG, meta)) {
+        cerr << "WARNING: Could not write graph cache " << cache_path << endl;
+      }
+    }
   }
 
   shared_ptr<FlowGraph> Llvm::getFlowGraph() const {
     return FG;
   }
 
+  shared_ptr<const CompactFlowGraph> Llvm::getCompactFlowGraph() const {
+    if (!CFG) {
+      CFG = make_shared<const CompactFlowGraph>(*FG);
+    }
+    return CFG;
+  }
+
   map<string, set<string>> Llvm::getBootstrapFns() const {
     return bootstrap_fns;
   }
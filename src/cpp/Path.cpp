@@ -4,10 +4,29 @@
 
 using namespace std;
 
-Path::Path(const Path &other) {
-  for (const auto &v : other.get_vertices()) {
-    add(v);
+Path Path::join(const Path &backward, const Path &forward) {
+  Path ret(backward.FG, backward.prefix);
+  flow_vertex_t redundant = backward.vertices[0];
+  for (auto it = backward.vertices.rbegin(); it != backward.vertices.rend(); ++it) {
+    if (*it != redundant) {
+      ret.vertices.push_back(*it);
+    }
+  }
+  for (auto it = backward.output_vertices.rbegin(); it != backward.output_vertices.rend(); ++it) {
+    if (*it != redundant) {
+      ret.output_vertices.push_back(*it);
+    }
+  }
+  ret.rebuild_signatures();
+
+  // The copy would have seen the vertices of backward in their original order
+  ret.parents = backward.parents;
+  ret.parent_bits = backward.parent_bits;
+
+  for (const flow_vertex_t v : forward.vertices) {
+    ret.add(v);
   }
+  return ret;
 }
 
 unsigned Path::calls_in_path() const {
@@ -22,56 +41,136 @@ bool Path::empty() const {
   return vertices.empty();
 }
 
+void Path::clear() {
+  vertices.clear();
+  output_vertices.clear();
+  output_signatures.clear();
+  parents.clear();
+  parent_bits = 0;
+  calls.valid = false;
+  handler_on.clear();
+  no_handler_on.clear();
+  return_str.clear();
+}
+
+void Path::push_output(flow_vertex_t v) {
+  output_vertices.push_back(v);
+  output_signatures.push_back(signature().extend(FG->G[v].key));
+}
+
+void Path::rebuild_signatures() {
+  output_signatures.clear();
+  PathSignature sig;
+  for (const flow_vertex_t v : output_vertices) {
+    sig = sig.extend(FG->G[v].key);
+    output_signatures.push_back(sig);
+  }
+}
+
+void Path::push_parent(uint32_t fn, uint32_t start) {
+  ParentRun run;
+  run.function = fn;
+  run.start = start;
+  parents.push_back(run);
+  parent_bits |= parent_bit(fn);
+}
+
 void Path::add(flow_vertex_t v) {
-  vertices.push_back(v);
-  if (is_output_call(v)) {
-    output_vertices.push_back(v);
+  // Checked against the functions before v, as v's own function may be the callee
+  bool output = is_output_call(v);
+  uint32_t fn = FG->function(v);
+  // A function new to the path can hide calls already in it
+  if (calls.valid && !in_parent_sequence(fn)) {
+    calls.valid = false;
   }
-  
-  std::string v_name = get_name(v);
-  if (parent_sequence.empty() || parent_sequence.back() != v_name) {
-    parent_sequence.push_back(v_name);
+  if (parents.empty() || parents.back().function != fn) {
+    push_parent(fn, vertices.size());
+  }
+
+  vertices.push_back(v);
+  if (output) {
+    push_output(v);
+    if (calls.valid) {
+      cache_call(vertices.size() - 1);
+    }
   }
 }
 
 void Path::remove(flow_vertex_t v) {
   vertices.erase(std::remove(vertices.begin(), vertices.end(), v), vertices.end());
   output_vertices.erase(std::remove(output_vertices.begin(), output_vertices.end(), v), output_vertices.end());
+  rebuild_signatures();
+  calls.valid = false;
 }
 
-void Path::remove_call(string call) {
-  for (const auto &v : get_output_vertices()) {
+void Path::remove_call(const string &call) {
+  output_vertices_t matching;
+  for (const auto &v : output_vertices) {
     if (call_name(v) == call) {
-      remove(v);
+      matching.push_back(v);
     }
   }
+  for (const auto &v : matching) {
+    remove(v);
+  }
 }
 
 void Path::reverse() {
   std::reverse(vertices.begin(), vertices.end());
   std::reverse(output_vertices.begin(), output_vertices.end());
+  rebuild_signatures();
+  calls.valid = false;
 }
 
-const vector<flow_vertex_t>& Path::get_vertices() const {
+const Path::vertices_t& Path::get_vertices() const {
   return vertices;
 }
 
-const vector<flow_vertex_t>& Path::get_output_vertices() const {
+const Path::output_vertices_t& Path::get_output_vertices() const {
   return output_vertices;
 }
 
-vector<string> Path::output() {
-  vector<string> ret;
-
-  bool in_err = false, in_no_err = false;
-  
-  for (const flow_vertex_t v : vertices) {
-    if (is_output_call(v)) {
-      string name = prefix + call_name(v);
+void Path::cache_call(uint32_t pos) {
+  flow_vertex_t v = vertices[pos];
 #ifdef DEBUG
-      name = name + " " + FG->G[v].loc.str();
+  calls.tokens.push_back(prefix + call_name(v) + " " + FG->G[v].loc.str());
+#else
+  calls.tokens.push_back(prefix + call_name(v));
 #endif
-      ret.push_back(name);
+  calls.positions.push_back(pos);
+}
+
+void Path::cache_calls() {
+  if (calls.valid) {
+    return;
+  }
+  calls.tokens.clear();
+  calls.positions.clear();
+  for (uint32_t i = 0; i < vertices.size(); ++i) {
+    if (is_output_call(vertices[i])) {
+      cache_call(i);
+    }
+  }
+  calls.valid = true;
+}
+
+template <typename Fn>
+void Path::for_each_output(Fn fn) {
+  cache_calls();
+  if (return_str.empty()) {
+    for (const string &token : calls.tokens) {
+      fn(token);
+    }
+    return;
+  }
+
+  bool in_err = false, in_no_err = false;
+  size_t next_call = 0;
+
+  for (uint32_t i = 0; i < vertices.size(); ++i) {
+    flow_vertex_t v = vertices[i];
+    if (next_call < calls.positions.size() && calls.positions[next_call] == i) {
+      fn(calls.tokens[next_call++]);
     }
 
     if (handler_on.find(v) != handler_on.end()) {
@@ -82,26 +181,54 @@ vector<string> Path::output() {
       in_no_err = true;
     }
 
-    if (is_return(v) && !return_str.empty()) {
+    if (FG->is_return(v)) {
       if (in_err) {
-        ret.push_back("RETURN_ERR");
+        fn("RETURN_ERR");
       } else if (in_no_err) {
-        ret.push_back("RETURN_NO_ERR");
+        fn("RETURN_NO_ERR");
       } else {
-        ret.push_back("RETURN_" + return_str);
+        fn("RETURN_" + return_str);
       }
-    }       
+    }
   }
-  
+}
+
+vector<string> Path::output() {
+  vector<string> ret;
+  ret.reserve(output_vertices.size() + 1);
+  for_each_output([&](const string &token) {
+    ret.push_back(token);
+  });
   return ret;
 }
 
-inline bool Path::is_return(flow_vertex_t v) {
-  if (boost::out_degree(v, FG->G) == 0) {
+bool Path::output(PathSink &sink) {
+  bool open = false;
+  for_each_output([&](const string &token) {
+    if (!open) {
+      sink.begin_path();
+      open = true;
+    }
+    sink.token(token);
+  });
+  if (open) {
+    sink.end_path();
+  }
+  return open;
+}
+
+bool Path::has_output() {
+  cache_calls();
+  if (!calls.tokens.empty()) {
     return true;
   }
-  BGL_FORALL_OUTEDGES(v, e, FG->G, _FlowGraph) {
-    if (FG->G[e].may_ret) return true;
+  if (return_str.empty()) {
+    return false;
+  }
+  for (const flow_vertex_t v : vertices) {
+    if (FG->is_return(v)) {
+      return true;
+    }
   }
   return false;
 }
@@ -114,99 +241,96 @@ string Path::get_callsite_sequence_idx() const {
   return ret;
 }
 
-void Path::rewind(flow_vertex_t v) {
+void Path::rewind(flow_vertex_t v, VisitedEpochs &visited) {
   if (!needs_rewind(v)) {
     return;
   }
-    
+
   while (!vertices.empty() && vertices.back() != v) {
     flow_vertex_t n = vertices.back();
     vertices.pop_back();
-    FG->G[n].visited = false;
-    
+    visited.unmark(FG->G[n].index);
+
     if (!output_vertices.empty() && output_vertices.back() == n) {
       output_vertices.pop_back();
+      output_signatures.pop_back();
     }
   }
 
   if (!vertices.empty()) {
     flow_vertex_t n = vertices.back();
-    FG->G[n].visited = false;
+    visited.unmark(FG->G[n].index);
   }
 
-  parents_valid = false;
+  calls.valid = false;
+  while (!parents.empty() && parents.back().start >= vertices.size()) {
+    parents.pop_back();
+  }
+  parent_bits = 0;
+  for (const ParentRun &run : parents) {
+    parent_bits |= parent_bit(run.function);
+  }
 }
 
 bool Path::needs_rewind(flow_vertex_t v) {
   return !vertices.empty() && vertices.back() != v;
 }
 
-bool Path::valid_match(Path &other) {
-  std::vector<std::string> this_sequence = get_parent_sequence();
-  std::vector<std::string> other_sequence = other.get_parent_sequence();
-
-  std::vector<std::string> shorter;
-  std::vector<std::string> longer;
-  if (this_sequence.size() <= other_sequence.size()) {
-    shorter = this_sequence;
-    longer  = other_sequence;
-  } else {
-    shorter = other_sequence;
-    longer  = this_sequence;
-  }
-       
-  for (unsigned i = 0; i < shorter.size(); ++i) {
-    if (shorter[i] != longer[i]) {
+bool Path::valid_match(const Path &other) const {
+  size_t shorter = min(parents.size(), other.parents.size());
+  for (size_t i = 0; i < shorter; ++i) {
+    if (parents[i].function != other.parents[i].function) {
       return false;
     }
   }
   return true;
 }
 
-bool Path::in_parent_sequence(const std::string &function_name) {
-  std::vector<std::string> sequence = get_parent_sequence();
-  return std::find(sequence.begin(), sequence.end(), function_name) != sequence.end();
+vector<PathSignature> Path::parent_prefix_signatures() const {
+  vector<PathSignature> ret;
+  ret.reserve(parents.size());
+  PathSignature sig;
+  for (const ParentRun &run : parents) {
+    sig = sig.extend(run.function);
+    ret.push_back(sig);
+  }
+  return ret;
 }
 
-bool Path::is_output_call(flow_vertex_t v) {
-  if (!is_call(*FG, v)) {
-    return false;
+vector<string> Path::get_parent_sequence() const {
+  vector<string> ret;
+  for (const ParentRun &run : parents) {
+    ret.push_back(FG->function_name(run.function));
   }
+  return ret;
+}
 
-  // Hide calls for functions that we are coming out of
-  // (interprocedural paths)
-  BGL_FORALL_OUTEDGES(v, e, FG->G, _FlowGraph) {
-    if (FG->G[e].call) {
-      FlowVertex callee = FG->G[target(e, FG->G)];
-      std::string name = callee.stack.substr(0, callee.stack.find("."));
-      if (in_parent_sequence(name)) {
-        return false;
-      }
+bool Path::in_parent_sequence(uint32_t fn) const {
+  if (!(parent_bits & parent_bit(fn))) {
+    return false;
+  }
+  for (const ParentRun &run : parents) {
+    if (run.function == fn) {
+      return true;
     }
   }
-  
-  return true;
+  return false;
 }
 
-string Path::call_name(flow_vertex_t v) const {
-  std::string name;
-  
-  // Indirect call
-  mem_t mem_index = FG->G[v].mem_index;
-  if (mem_index) {
-    name = mem_index->name();
-    replace(name.begin(), name.end(), '.', '_');
-    return name;
+bool Path::is_output_call(flow_vertex_t v) const {
+  if (!FG->is_call(v)) {
+    return false;
   }
-    
-  BGL_FORALL_OUTEDGES(v, e, FG->G, _FlowGraph) {
-    if (FG->G[e].call) {
-      FlowVertex callee = FG->G[target(e, FG->G)];
-      return callee.stack.substr(0, callee.stack.find("."));
+
+  // Hide calls for functions that we are coming out of
+  // (interprocedural paths)
+  for (const uint32_t *callee = FG->callees_begin(v); callee != FG->callees_end(v); ++callee) {
+    if (in_parent_sequence(*callee)) {
+      return false;
     }
   }
 
-  return name;
+  return true;
 }
 
 string Path::str() {
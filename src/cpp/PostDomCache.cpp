@@ -0,0 +1,50 @@
+#include "PostDomCache.hpp"
+
+using namespace llvm;
+using namespace std;
+
+namespace ep {
+
+namespace {
+
+// Rough size of a tree per basic block: the node, its child list and the
+// block to node map entry
+const size_t BYTES_PER_BLOCK = 128;
+
+}
+
+PostDominatorTree& PostDomCache::get(Function &F) {
+  ++num_lookups;
+  auto it = entries.find(&F);
+  if (it != entries.end()) {
+    lru.splice(lru.begin(), lru, it->second);
+    return *lru.front().tree;
+  }
+
+  Entry entry;
+  entry.F = &F;
+  entry.tree.reset(new PostDominatorTree());
+  entry.tree->runOnFunction(F);
+  entry.bytes = sizeof(PostDominatorTree) + F.size() * BYTES_PER_BLOCK;
+  ++num_builds;
+
+  // Always keep the tree being returned, even if it alone is over budget
+  while (!lru.empty() && used + entry.bytes > budget) {
+    used -= lru.back().bytes;
+    entries.erase(lru.back().F);
+    lru.pop_back();
+  }
+
+  used += entry.bytes;
+  lru.push_front(std::move(entry));
+  entries[&F] = lru.begin();
+  return *lru.front().tree;
+}
+
+void PostDomCache::clear() {
+  lru.clear();
+  entries.clear();
+  used = 0;
+}
+
+}
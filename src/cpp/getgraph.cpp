@@ -1,12 +1,16 @@
 #include <Llvm.hpp>
 #include <edgelist.pb.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <boost/program_options.hpp>
 
 using namespace std;
 
-void print_edgelist(FlowGraph &FG, bool use_ints);
+template <typename GraphTy>
+void print_edgelist(const GraphTy &G, bool use_ints);
 
-void print_edgelist_protobuf(FlowGraph &FG, const std::unordered_map<int, std::string> &id_to_label);
+template <typename GraphTy>
+void print_edgelist_protobuf(const GraphTy &G, const std::unordered_map<int, std::string> &id_to_label);
 
 // Just dumps the graph. We transform in the walker.
 int main(int argc, char **argv) {
@@ -18,8 +22,10 @@ int main(int argc, char **argv) {
       ("help", "produce help message")
       ("bitcode", po::value<string>()->required(), "Path to bitcode file")
       ("edgelist", po::bool_switch(), "Output labeled edgelist")
-      ("protobuf", po::bool_switch(), "Use binary protobuf format")
+      ("protobuf", po::bool_switch(), "Use streaming, length-delimited protobuf format")
       ("remove-cross-folder", po::bool_switch(), "Remove cross-folder call edges coming from points-to analysis.")
+      ("threads", po::value<unsigned>()->default_value(1), "Worker threads for building the ICFG (0 = all cores)")
+      ("cache-dir", po::value<string>(), "Directory for cached ICFGs, reused while the inputs are unchanged")
       ("output", po::value<string>())
       ("error-codes", po::value<string>(), "Path to error codes file");
   po::variables_map vm;
@@ -42,84 +48,171 @@ int main(int argc, char **argv) {
     remove_cross_folder = true;
   }
 
+  string cache_dir;
+  if (vm.count("cache-dir")) {
+    cache_dir = vm["cache-dir"].as<string>();
+  }
+
   // Get the ICFG
-  p2v::Llvm passes(vm["bitcode"].as<string>(), error_codes, remove_cross_folder);
-  shared_ptr<FlowGraph> FG = passes.getFlowGraph();
-  if (!FG) {
+  p2v::Llvm passes(vm["bitcode"].as<string>(), error_codes, remove_cross_folder,
+                   vm["threads"].as<unsigned>(), cache_dir);
+  shared_ptr<const CompactFlowGraph> CFG = passes.getCompactFlowGraph();
+  if (!CFG) {
     throw "Empty ICFG";
   }
 
+  if (remove_cross_folder) {
+    cerr << "Metrics" << endl
+         << "======" << endl
+         << "Cross-folder call edges pruned: " << passes.cross_folder_pruned << endl;
+  }
+
   if (vm["edgelist"].as<bool>()) {
     if (vm["protobuf"].as<bool>()) {
-      print_edgelist_protobuf(*FG, passes.id_to_label);
+      print_edgelist_protobuf(*CFG, passes.id_to_label);
     } else {
-      print_edgelist(*FG, vm["int"].as<bool>());
+      print_edgelist(*CFG, vm["int"].as<bool>());
     }
   }
 
   return 0;
 }
 
-// TODO: Some decisions are made here about what gets labeled.
-// Make it easy to keep print_egelist_protobuf synchronized with print_edgelist
-void print_edgelist_protobuf(FlowGraph &FG, const std::unordered_map<int, std::string> &id_to_label) {
-  func2vec::Edgelist edgelist;
-
-  BGL_FORALL_EDGES(e, FG.G, _FlowGraph) {
-      FlowVertex &source = FG.G[boost::source(e, FG.G)];
-      FlowVertex &target = FG.G[boost::target(e, FG.G)];
-      func2vec::Edgelist_Edge *edge = edgelist.add_edge();
-      edge->set_source(source.stack);
-      edge->set_target(target.stack);
-
-      if (FG.G[e].may_ret) {
-        edge->set_label("may_ret");
-      } else if (FG.G[e].call) {
-        edge->set_label("call");
-      } else if (FG.G[e].ret) {
-        edge->set_label("ret");
-      } else if (!source.label_ids.empty()) {
-        for (const auto &id : source.label_ids) {
-          edge->add_label_id(id);
-        }
-      }
+// Streaming edgelist. A single Edgelist message with every edge in it needs
+// the whole graph in memory twice and overflows protobuf's 2GB message limit on
+// large kernels. Instead the output is a sequence of EdgelistChunk messages
+// (see edgelist.proto), each prefixed by its varint length (as in
+// writeDelimitedTo). The first chunk holds id_to_label, then come the vertices
+// and then the edges, at most EDGELIST_CHUNK_SIZE of either per chunk.
+// walker.pushdown reads it back.
+namespace {
 
-      // Location of source node
-      if (!source.loc.empty()) {
-        edge->set_location(source.loc.str());
-      }
+const size_t EDGELIST_CHUNK_SIZE = 1 << 16;
 
-      assert(edge->label_id_size() == 0 || edge->label().empty());
+using func2vec::EdgelistChunk;
+
+// Buffers one chunk at a time and writes it to the stream with its length prefix
+class EdgelistChunkWriter {
+public:
+  explicit EdgelistChunkWriter(ostream &os) : os(os) {}
+
+  ~EdgelistChunkWriter() {
+    flush();
+  }
+
+  void add_label(int id, const string &label) {
+    (*chunk.mutable_id_to_label())[id].set_label(label);
+  }
+
+  void add_vertex(const string &stack, const string &location) {
+    chunk.add_vertex(stack);
+    chunk.add_vertex_location(location);
+    if (static_cast<size_t>(chunk.vertex_size()) >= EDGELIST_CHUNK_SIZE) {
+      flush();
     }
+  }
 
-  auto *m = edgelist.mutable_id_to_label();
-  for (const auto &kv : id_to_label) {
-    func2vec::Edgelist_Label label;
-    label.set_label(kv.second);
-    bool ok = m->insert({kv.first, label}).second;
-    assert(ok);
+  template <typename LabelRange>
+  void add_edge(uint32_t source, uint32_t target, EdgelistChunk::Kind kind, const LabelRange &labels) {
+    chunk.add_source(source);
+    chunk.add_target(target);
+    chunk.add_kind(kind);
+    uint32_t count = 0;
+    for (int id : labels) {
+      chunk.add_label_id(id);
+      ++count;
+    }
+    chunk.add_label_count(count);
+    if (static_cast<size_t>(chunk.source_size()) >= EDGELIST_CHUNK_SIZE) {
+      flush();
+    }
+  }
+
+  void flush() {
+    size_t size = chunk.ByteSizeLong();
+    if (size == 0) {
+      return;
+    }
+    {
+      google::protobuf::io::OstreamOutputStream os_stream(&os);
+      google::protobuf::io::CodedOutputStream out(&os_stream);
+      // Map entries in key order, so the output does not depend on hash order
+      out.SetSerializationDeterministic(true);
+      out.WriteVarint32(size);
+      chunk.SerializeWithCachedSizes(&out);
+    }
+    chunk.Clear();
   }
 
-  edgelist.SerializeToOstream(&cout);
+private:
+  ostream &os;
+  EdgelistChunk chunk;
+};
+
+}
+
+// TODO: Some decisions are made here about what gets labeled.
+// Make it easy to keep print_egelist_protobuf synchronized with print_edgelist
+// Templatized so it runs on either the FlowGraph or the CompactFlowGraph
+template <typename GraphTy>
+void print_edgelist_protobuf(const GraphTy &G, const std::unordered_map<int, std::string> &id_to_label) {
+  EdgelistChunkWriter writer(cout);
+
+  for (const auto &kv : id_to_label) {
+    writer.add_label(kv.first, kv.second);
+  }
+  writer.flush();
+
+  // Vertex ids in output order, indexed by FlowVertex::index
+  vector<uint32_t> vertex_ids;
+  uint32_t next_id = 0;
+  BGL_FORALL_VERTICES_T(v, G, GraphTy) {
+    const auto &vertex = G[v];
+    if (vertex.index >= vertex_ids.size()) {
+      vertex_ids.resize(vertex.index + 1);
+    }
+    vertex_ids[vertex.index] = next_id++;
+    writer.add_vertex(vertex.stack, vertex.loc.empty() ? "" : vertex.loc.str());
+  }
+  writer.flush();
+
+  const vector<int> no_labels;
+  BGL_FORALL_EDGES_T(e, G, GraphTy) {
+      const auto &source = G[boost::source(e, G)];
+      const auto &target = G[boost::target(e, G)];
+      uint32_t from = vertex_ids[source.index], to = vertex_ids[target.index];
+
+      if (G[e].may_ret) {
+        writer.add_edge(from, to, EdgelistChunk::MAY_RET, no_labels);
+      } else if (G[e].call) {
+        writer.add_edge(from, to, EdgelistChunk::CALL, no_labels);
+      } else if (G[e].ret) {
+        writer.add_edge(from, to, EdgelistChunk::RET, no_labels);
+      } else {
+        writer.add_edge(from, to, EdgelistChunk::NONE, source.label_ids);
+      }
+    }
+  writer.flush();
+  cout.flush();
 
   google::protobuf::ShutdownProtobufLibrary();
 }
 
-// TODO: const-safe way of retrieving vertices
 // Output format is meant to match networkx.read_edgelist
-void print_edgelist(FlowGraph &FG, bool use_ints) {
+template <typename GraphTy>
+void print_edgelist(const GraphTy &G, bool use_ints) {
   map<string, int> stack_to_int;
 
-  BGL_FORALL_EDGES(e, FG.G, _FlowGraph) {
-      FlowVertex &source = FG.G[boost::source(e, FG.G)];
-      FlowVertex &target = FG.G[boost::target(e, FG.G)];
+  BGL_FORALL_EDGES_T(e, G, GraphTy) {
+      const auto &source = G[boost::source(e, G)];
+      const auto &target = G[boost::target(e, G)];
 
       cout << source.stack << " " << target.stack;
-      if (FG.G[e].may_ret) {
+      if (G[e].may_ret) {
         cout << " may_ret";
-      } else if (FG.G[e].call) {
+      } else if (G[e].call) {
         cout << " call";
-      } else if (FG.G[e].ret) {
+      } else if (G[e].ret) {
         cout << " ret";
       }
 
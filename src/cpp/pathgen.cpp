@@ -1,4 +1,8 @@
 #include "Context.hpp"
+#include "Parallel.hpp"
+#include "GzipStream.hpp"
+#include <fstream>
+#include <getopt.h>
 
 using namespace std;
 using namespace p2v;
@@ -7,21 +11,39 @@ const unsigned DEFAULT_P = 200;
 
 void usage() {
   cerr << "Usage: main\t-b <bitcode file> -i <interesting functions file> [-e <error codes file>] [-c]" << endl
-       << "\t\t[-p <max path length] [-l]" << endl << endl
+       << "\t\t[-p <max path length] [-l] [-o <output file>] [-z]" << endl << endl
        << "-c will enable CALLER_ paths." << endl
        << "-e will enable error path annotations." << endl
-       << "-r <string> will set early return string (default RETURN_DEFAULT), requires -e" << endl;
+       << "-r <string> will set early return string (default RETURN_DEFAULT), requires -e" << endl
+       << "-j <threads> will search call sites in parallel (0 = all cores, default 1). Output is the same." << endl
+       << "-o <file> will write the paths to file instead of stdout." << endl
+       << "-z will gzip the paths." << endl
+       << "--corpus will write the paths as a binary corpus, and its vocabulary to <output file>.vocab. Requires -o." << endl
+       << "--cache-dir <dir> will reuse the ICFG between runs on the same inputs." << endl;
 }
 
 int main(int argc, char **argv) {
-  string arg_bitcode_path, arg_interesting_path, arg_path_length;
+  string arg_bitcode_path, arg_interesting_path, arg_path_length, arg_threads;
   bool arg_bootstrap_output = false, arg_callinfo = false, arg_err_annotations = false;
-  string arg_return_str, arg_ec_path;
+  string arg_return_str, arg_ec_path, arg_cache_dir, arg_output_path;
+  bool arg_gzip = false, arg_corpus = false;
   unsigned p = DEFAULT_P;
 
+  static const struct option long_options[] = {
+    {"cache-dir", required_argument, nullptr, 'C'},
+    {"corpus", no_argument, nullptr, 'B'},
+    {nullptr, 0, nullptr, 0}
+  };
+
   int c;
-  while ((c = getopt(argc, argv, "b:i:p:lce:r:")) != EOF) {
+  while ((c = getopt_long(argc, argv, "b:i:p:lce:r:j:o:z", long_options, nullptr)) != EOF) {
     switch(c) {
+    case 'C':
+      arg_cache_dir = optarg;
+      break;
+    case 'B':
+      arg_corpus = true;
+      break;
     case 'b':
       arg_bitcode_path = optarg;
       break;
@@ -43,6 +65,15 @@ int main(int argc, char **argv) {
     case 'r':
       arg_return_str = optarg;
       break;
+    case 'j':
+      arg_threads = optarg;
+      break;
+    case 'o':
+      arg_output_path = optarg;
+      break;
+    case 'z':
+      arg_gzip = true;
+      break;
     }
   }
 
@@ -61,9 +92,20 @@ int main(int argc, char **argv) {
     }
   }
 
+  unsigned threads = 1;
+  if (!arg_threads.empty()) {
+    istringstream ss(arg_threads);
+    ss >> threads;
+    if (ss.fail()) {
+      cerr << "Unrecognized thread count. Please choose j >= 0.\n";
+      return 1;
+    }
+    threads = ep::resolve_threads(threads);
+  }
+
   if (arg_bootstrap_output) {
     // Just print the bootstrap functions and exit
-    Llvm passes(arg_bitcode_path);
+    Llvm passes(arg_bitcode_path, "", false, 1, arg_cache_dir);
     map<string, set<string>> bootstrap_functions = passes.getBootstrapFns();
     for (auto i = bootstrap_functions.begin(), e = bootstrap_functions.end(); i != e; ++i) {
       string group_id = i->first;
@@ -95,14 +137,56 @@ int main(int argc, char **argv) {
     return_str = "DEFAULT";
   }
     
+  string vocab_path;
+  if (arg_corpus) {
+    if (arg_output_path.empty()) {
+      cerr << "--corpus requires -o.\n";
+      return 1;
+    }
+    if (arg_gzip) {
+      cerr << "--corpus cannot be combined with -z, a corpus is read through a memory mapping.\n";
+      return 1;
+    }
+    vocab_path = arg_output_path + ".vocab";
+  }
+
+  ofstream output_file;
+  if (!arg_output_path.empty()) {
+    output_file.open(arg_output_path, ios::binary);
+    if (!output_file) {
+      cerr << "Could not open " << arg_output_path << " for writing.\n";
+      return 1;
+    }
+  }
+  ostream &raw_output = arg_output_path.empty() ? cout : output_file;
+
+  // Paths are written as they are generated, so nothing is held back for compression
+  unique_ptr<ep::GzipOStream> gzip_output;
+  if (arg_gzip) {
+    gzip_output.reset(new ep::GzipOStream(raw_output));
+  }
+  ostream &output = gzip_output ? *gzip_output : raw_output;
+
   run_k_context_on_file(arg_bitcode_path,
                         arg_interesting_path,
-                        cout,
+                        output,
                         p,
                         arg_callinfo,
                         !arg_ec_path.empty(),
                         return_str,
-                        arg_ec_path);
+                        arg_ec_path,
+                        arg_cache_dir,
+                        threads,
+                        vocab_path);
+
+  if (gzip_output) {
+    gzip_output->close();
+  }
+  raw_output.flush();
+  if (!output || !raw_output) {
+    cerr << "Error writing paths.\n";
+    return 1;
+  }
 
   return 0;
 }
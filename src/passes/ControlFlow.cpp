@@ -1,6 +1,6 @@
 #include "ControlFlow.hpp"
+#include "Parallel.hpp"
 #include <llvm/IR/CFG.h>
-#include <llvm/IR/InstIterator.h>
 
 using namespace llvm;
 using namespace std;
@@ -9,53 +9,79 @@ using namespace ep;
 static llvm::RegisterPass<ControlFlowPass> C("control-flow", "Build CFG", false, false);
 static cl::opt<string> WriteDot("dot-epcfg", cl::desc("Write dot file for EP CFG"));
 static cl::opt<string> DotStart("dot-start", cl::desc("(Optional) function to start dot file at"));
+static cl::opt<unsigned> CFGThreads("cfg-threads", cl::desc("Worker threads for building the ICFG (0 = all cores)"));
+
+// Functions walked per round. Bounds how many recorded adds are alive at once.
+static const size_t FUNCTIONS_PER_THREAD = 64;
 
 bool ControlFlowPass::runOnModule(Module &M) {
   names = &getAnalysis<NamesPass>();
+  sources = &getAnalysis<FunctionSourcePass>();
+  FG->setStackNames(names->getStackNames());
 
   Function *main = M.getFunction("main");
   FlowVertex main_v("main.0", main);
-  FG.add(main_v);
+  FG->add(main_v);
 
   if (main) {
     BasicBlock &entry = main->getEntryBlock();
-    string entry_name;
-    tie(entry_name, std::ignore) = names->getBBNames(entry);
-    FlowVertex entry_v(entry_name, main);
-    FlowGraph::add_t added = FG.add(main_v, entry_v);
+    stack_key_t entry_key;
+    tie(entry_key, std::ignore) = names->getBBKeys(entry);
+    FlowVertex entry_v(entry_key, main);
+    FlowGraph::add_t added = FG->add(main_v, entry_v);
     fn2vtx[main] = std::get<0>(added);
   }
 
+  vector<Function*> functions;
   for (Module::iterator f = M.begin(), e = M.end(); f != e; ++f) {
     if (f->isIntrinsic() || f->isDeclaration()) {
       continue;
     }
+    functions.push_back(&*f);
+  }
 
-    FlowVertex fn_v(names->getCallName(*f), &*f);
-    if (!main) {
-      FlowGraph::add_t added = FG.add(main_v, fn_v);
+  unsigned workers = ep::resolve_threads(CFGThreads.getNumOccurrences() ? CFGThreads : threads);
+  size_t round = workers * FUNCTIONS_PER_THREAD;
+  for (size_t begin = 0; begin < functions.size(); begin += round) {
+    size_t end = std::min(functions.size(), begin + round);
 
-      flow_edge_t edge_from_main = std::get<3>(added);
-      FG.G[edge_from_main].main = true;
+    vector<FlowGraphOps> ops(end - begin);
+    ep::parallel_for(end - begin, workers, [&](size_t i) {
+      recordFunction(functions[begin + i], ops[i]);
+    });
 
-      flow_vertex_t fn_entry = std::get<1>(added);
-      fn2vtx[&*f] = fn_entry;
-    }
+    for (size_t i = begin; i < end; ++i) {
+      Function *f = functions[i];
+
+      FlowVertex fn_v(names->getCallKey(*f), f);
+      if (!main) {
+        FlowGraph::add_t added = FG->add(main_v, fn_v);
 
-    // Connect function to first basic block
-    BasicBlock &entry = f->getEntryBlock();
-    string bbe;
-    tie(bbe, std::ignore) = names->getBBNames(entry);
-    FlowVertex entry_v(bbe, &*f);
-    FG.add(fn_v, entry_v);
+        flow_edge_t edge_from_main = std::get<3>(added);
+        FG->G[edge_from_main].main = true;
 
-    runOnFunction(&*f);
+        flow_vertex_t fn_entry = std::get<1>(added);
+        fn2vtx[f] = fn_entry;
+      }
+
+      // Connect function to first basic block
+      BasicBlock &entry = f->getEntryBlock();
+      stack_key_t bbe;
+      tie(bbe, std::ignore) = names->getBBKeys(entry);
+      FlowVertex entry_v(bbe, f);
+      FG->add(fn_v, entry_v);
+
+      replay(f, ops[i - begin]);
+      FlowGraphOps().swap(ops[i - begin]);
+    }
   }
 
   for (Module::iterator f = M.begin(), e = M.end(); f != e; ++f) {
     addMayReturnEdges(*f);
   }
 
+  FG->finalize();
+
   if (!WriteDot.empty()) {
     write_dot(WriteDot);
   }
@@ -63,6 +89,10 @@ bool ControlFlowPass::runOnModule(Module &M) {
   return false;
 }
 
+unique_ptr<FlowGraph> ControlFlowPass::releaseFlowGraph() {
+  return std::move(FG);
+}
+
 flow_vertex_t ControlFlowPass::getFunctionVertex(const llvm::Function *F) const {
   return fn2vtx.at(F);
 }
@@ -72,9 +102,9 @@ void ControlFlowPass::write_dot(const string path) {
 
   if (!DotStart.empty()) {
     string start_stack = DotStart + ".0";
-    FG.write_graphviz(out, start_stack);
+    FG->write_graphviz(out, start_stack);
   } else {
-    FG.write_graphviz(out);
+    FG->write_graphviz(out);
   }
 
   out.close();
@@ -88,41 +118,52 @@ void boost::throw_exception(std::exception const &e) {
 }
 
 void ControlFlowPass::runOnFunction(Function *F) {
+  FlowGraphOps ops;
+  recordFunction(F, ops);
+  replay(F, ops);
+}
+
+void ControlFlowPass::recordFunction(Function *F, FlowGraphOps &ops) {
   for (auto bi = F->begin(), be = F->end(); bi != be; ++bi) {
-    string bb_enter, bb_exit;
-    tie(bb_enter, bb_exit) = names->getBBNames(*bi);
+    stack_key_t bb_enter, bb_exit;
+    tie(bb_enter, bb_exit) = names->getBBKeys(*bi);
 
     // Connect exit of each predecessor block to entry of this block
     FlowVertex bbe_v(bb_enter, F);
     for (auto pi = pred_begin(&*bi), pe = pred_end(&*be); pi != pe; ++pi) {
       BasicBlock *pred = *pi;
-      string pred_exit;
-      tie(std::ignore, pred_exit) = names->getBBNames(*pred);
+      stack_key_t pred_exit;
+      tie(std::ignore, pred_exit) = names->getBBKeys(*pred);
       FlowVertex predx_v(pred_exit, F);
-      FG.add(predx_v, bbe_v);
+      ops.push_back(FlowGraphOp{predx_v, bbe_v, FlowVertex()});
     }
 
     BasicBlock *bb = &*bi;
     FlowVertex prev = bbe_v;
     for (auto ii = bb->begin(), ie = bb->end(); ii != ie; ++ii) {
       Instruction *i = &*ii;
-      prev = visitInstruction(i, prev);
+      prev = recordInstruction(i, prev, ops);
 
-      FlowGraph::add_t added;
       if (i == bb->getTerminator()) {
         FlowVertex bbx_v(bb_exit, F);
-        added = FG.add(prev, bbx_v);
+        ops.push_back(FlowGraphOp{prev, bbx_v, FlowVertex(), isa<ReturnInst>(i)});
       }
+    }
+  }
+}
 
-      // Populate fn2ret
-      if (isa<ReturnInst>(i)) {
-        flow_vertex_t ret_vtx = std::get<1>(added);
-        if (!ret_vtx) {
-//          cerr << "WARNING : ControlFlowPass::visitInstruction received null return vertex\n";
-          return;
-        }
-        fn2ret[F] = ret_vtx;
+void ControlFlowPass::replay(Function *F, const FlowGraphOps &ops) {
+  for (const FlowGraphOp &op : ops) {
+    FlowGraph::add_t added = FG->add(op.from, op.to1, op.to2);
+
+    // Populate fn2ret
+    if (op.ret) {
+      flow_vertex_t ret_vtx = std::get<1>(added);
+      if (!ret_vtx) {
+//          cerr << "WARNING : ControlFlowPass::replay received null return vertex\n";
+        return;
       }
+      fn2ret[F] = ret_vtx;
     }
   }
 }
@@ -132,8 +173,7 @@ void ControlFlowPass::addMayReturnEdges(Function &F) {
     return;
   }
 
-  string stack = names->getCallName(F);
-  flow_vertex_t vtx = FG.getVertex(stack);
+  flow_vertex_t vtx = FG->getVertex(names->getCallKey(F));
 
   if (!vtx) {
 //    cerr << "WARNING: ControlFlowPass::addMayReturnEdges unable to find vertex for stack\n";
@@ -142,16 +182,16 @@ void ControlFlowPass::addMayReturnEdges(Function &F) {
 
   vector<flow_vertex_t> return_sites;
   flow_in_edge_iter iei, iei_end;
-  for (tie(iei, iei_end) = in_edges(vtx, FG.G); iei != iei_end; ++iei) {
-    FlowEdge e = FG.G[*iei];
+  for (tie(iei, iei_end) = in_edges(vtx, FG->G); iei != iei_end; ++iei) {
+    FlowEdge e = FG->G[*iei];
     if (e.call) {
-      flow_vertex_t call_site = source(*iei, FG.G);
+      flow_vertex_t call_site = source(*iei, FG->G);
 
       // We add an edge to the vertex immediately after call site
       flow_out_edge_iter oei, oei_end;
-      for (tie(oei, oei_end) = out_edges(call_site, FG.G); oei != oei_end; ++oei) {
-        if (FG.G[*oei].ret) {
-          flow_vertex_t ret_to = target(*oei, FG.G);
+      for (tie(oei, oei_end) = out_edges(call_site, FG->G); oei != oei_end; ++oei) {
+        if (FG->G[*oei].ret) {
+          flow_vertex_t ret_to = target(*oei, FG->G);
           return_sites.push_back(ret_to);
           break;
         }
@@ -170,8 +210,8 @@ void ControlFlowPass::addMayReturnEdges(Function &F) {
   for (flow_vertex_t ret_to : return_sites) {
     bool success;
     flow_edge_t may_ret;
-    tie(may_ret, success) = boost::add_edge(ret_from, ret_to, FG.G);
-    FG.G[may_ret].may_ret = true;
+    tie(may_ret, success) = boost::add_edge(ret_from, ret_to, FG->G);
+    FG->G[may_ret].may_ret = true;
     if (!success) {
 //      cerr << "WARNING: ContolFlowPass::addMayReturnEdges failed to add return edge\n";
       return;
@@ -179,9 +219,9 @@ void ControlFlowPass::addMayReturnEdges(Function &F) {
   }
 }
 
-FlowVertex ControlFlowPass::visitInstruction(Instruction *I, FlowVertex prev) {
+FlowVertex ControlFlowPass::recordInstruction(Instruction *I, FlowVertex prev, FlowGraphOps &ops) {
   if (!I) {
-    cerr << "FATAL ERROR: ControlFlowPass::visitInstruction called with null instruction\n";
+    cerr << "FATAL ERROR: ControlFlowPass::recordInstruction called with null instruction\n";
     abort();
   }
 
@@ -189,25 +229,22 @@ FlowVertex ControlFlowPass::visitInstruction(Instruction *I, FlowVertex prev) {
     return prev;
   }
 
-  string iid = names->getStackName(*I);
+  stack_key_t iid = names->getStackKey(*I);
 
   FlowVertex i_v(iid, getSource(I), I);
   // Add the vertex. Be careful of the insanity of FlowGraph properties being overwritten if
   // add is called on vertices that already exist.
-  FlowGraph::add_t added = FG.add(prev, i_v);
-
-  flow_vertex_t from = std::get<0>(added);
+  ops.push_back(FlowGraphOp{prev, i_v, FlowVertex()});
 
   // CallInst are not terminators, so all calls are guaranteed to be visited as prev
   if (prev.I && isa<CallInst>(prev.I)) {
-    addCalls(from, i_v);
+    recordCalls(prev, i_v, ops);
   }
 
   return i_v;
 }
 
-void ControlFlowPass::addCalls(flow_vertex_t call_desc, FlowVertex ret_v) {
-  FlowVertex call_v = FG.G[call_desc];
+void ControlFlowPass::recordCalls(FlowVertex call_v, FlowVertex ret_v, FlowGraphOps &ops) {
   CallInst *call = dyn_cast<CallInst>(call_v.I);
   if (!call) abort();
 
@@ -218,7 +255,7 @@ void ControlFlowPass::addCalls(flow_vertex_t call_desc, FlowVertex ret_v) {
   if (f && f->isDeclaration()) {
     string call_name = f->getName().str();
     FlowVertex callee_v(call_name, call->getParent()->getParent());
-    FG.add(call_v, callee_v, ret_v);
+    ops.push_back(FlowGraphOp{call_v, callee_v, ret_v});
     return;
   }
 
@@ -257,64 +294,27 @@ void ControlFlowPass::addCalls(flow_vertex_t call_desc, FlowVertex ret_v) {
     fn_t callee_fn = static_pointer_cast<FunctionName>(callee_vn);
     Function *callee = callee_fn->function;
 
-    // ==============================================
-    // FIXME!: HACK put this somewhere, anywhere else.
-    // If the mem_index is populated, then this came from the points-to analysis.
-    // FIXME: Use boost. Handle absolute vs. not absolute paths.
+    // Drop points-to call edges that cross top-level source directories
     bool add_edge = true;
     if (remove_cross_folder && call_v.mem_index) {
-      string file1, file2;
-      string component_f1, component_f2;
-
-      DILocation *loc = nullptr;
-      Function *f = callee_fn->function;
-      // Get location of the calling function
       assert(call_v.I);
-      f = call_v.I->getParent()->getParent();
-      // Refactor this loop into a function that can be used by definedfunctions pass and here.
-      for (inst_iterator I = inst_begin(f), E = inst_end(f); I != E; ++I) {
-        if (loc = I->getDebugLoc()) {
-          file1 = loc->getFilename();
-          if (file1.find('.') == 0) {
-            file1 = file1.substr(2);
-          }
-          auto idx = file1.find('/');
-          component_f1 = file1.substr(0, idx);
-          break;
-        }
-      }
-
-      // Get location of the called function
-      f = callee_fn->function;
-      for (inst_iterator I = inst_begin(f), E = inst_end(f); I != E; ++I) {
-        if (loc = I->getDebugLoc()) {
-          file2 = loc->getFilename();
-          if (file2.find('.') == 0) {
-            file2 = file2.substr(2);
-          }
-          auto idx = file2.find('/');
-          component_f2 = file2.substr(0, idx);
-          break;
-        }
-      }
-
-      if (component_f1 != component_f2 && component_f1 != "include" && component_f2 != "include") {
+      Function *caller = call_v.I->getParent()->getParent();
+      if (!sources->sameComponent(caller, callee)) {
         add_edge = false;
+        ++cross_folder_pruned;
       }
     }
-    // ==============================================
-
 
-    string call_name = names->getCallName(*callee);
-    FlowVertex callee_v(call_name, call->getParent()->getParent());
+    FlowVertex callee_v(names->getCallKey(*callee), call->getParent()->getParent());
     if (add_edge) {
-      FG.add(call_v, callee_v, ret_v);
+      ops.push_back(FlowGraphOp{call_v, callee_v, ret_v});
     }
   }
 }
 
 void ControlFlowPass::getAnalysisUsage(AnalysisUsage &AU) const {
   AU.addRequired<NamesPass>();
+  AU.addRequired<FunctionSourcePass>();
   AU.setPreservesAll();
 }
 
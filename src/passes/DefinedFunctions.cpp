@@ -1,8 +1,8 @@
+#include "FunctionSource.hpp"
 #include "llvm/Pass.h"
 #include "llvm/IR/Function.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/IR/DebugInfo.h"
-#include "llvm/IR/InstIterator.h"
 #include <iostream>
 #include <string>
 
@@ -22,18 +22,10 @@ struct DefinedFunctions : public FunctionPass {
       fname = fname.substr(0, idx);
     }
 
-    // Getting metadata for the actual function information is a pain
-    // (need to loop over all of the DISubprograms). We only need the
-    // directory and filename here, so I just get the debug location of
-    // the first instruction in the function that contains metadata.
-
-    DILocation *loc = nullptr;
-    for (inst_iterator I = inst_begin(F), E = inst_end(F); I != E; ++I) {
-      if (loc = I->getDebugLoc()) {
-        string file = loc->getFilename();
-        cout << file << " " << fname << endl;
-        break;
-      }
+    const DILocation *loc = ep::getFirstDebugLoc(F);
+    if (loc) {
+      string file = loc->getFilename();
+      cout << file << " " << fname << endl;
     }
     assert(loc);
     return false;
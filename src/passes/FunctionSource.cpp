@@ -0,0 +1,64 @@
+#include "FunctionSource.hpp"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/Module.h"
+
+using namespace llvm;
+using namespace std;
+
+char FunctionSourcePass::ID = 0;
+static RegisterPass<FunctionSourcePass> FS("function-source", "Source file of each function", false, true);
+
+namespace ep {
+  // Getting metadata for the actual function information is a pain
+  // (need to loop over all of the DISubprograms). We only need the
+  // directory and filename, so we use the first instruction with a location.
+  const DILocation* getFirstDebugLoc(const Function &F) {
+    for (const_inst_iterator I = inst_begin(F), E = inst_end(F); I != E; ++I) {
+      if (const DILocation *loc = I->getDebugLoc()) {
+        return loc;
+      }
+    }
+    return nullptr;
+  }
+}
+
+bool FunctionSourcePass::runOnModule(Module &M) {
+  include_id = strings.intern("include");
+
+  for (Function &F : M) {
+    if (F.isIntrinsic() || F.isDeclaration()) {
+      continue;
+    }
+
+    const DILocation *loc = ep::getFirstDebugLoc(F);
+    if (!loc) {
+      continue;
+    }
+
+    // Relative paths are written ./dir/file.c
+    string file = loc->getFilename().str();
+    if (file.find('.') == 0) {
+      file = file.substr(2);
+    }
+    string component = file.substr(0, file.find('/'));
+
+    FunctionSource source;
+    source.file = strings.intern(file);
+    source.component = strings.intern(component);
+    sources[&F] = source;
+  }
+
+  return false;
+}
+
+FunctionSource FunctionSourcePass::getSource(const Function *F) const {
+  auto it = sources.find(F);
+  if (it == sources.end()) {
+    return FunctionSource();
+  }
+  return it->second;
+}
+
+void FunctionSourcePass::getAnalysisUsage(AnalysisUsage &AU) const {
+  AU.setPreservesAll();
+}
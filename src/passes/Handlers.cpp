@@ -2,16 +2,20 @@
 #include "BranchSafety.hpp"
 #include "llvm/Analysis/MemoryDependenceAnalysis.h"
 #include "llvm/Analysis/PostDominators.h"
+#include "llvm/Support/CommandLine.h"
+#include <algorithm>
+#include <chrono>
 
 using namespace llvm;
 using namespace std;
 
-void HandlersPass::addBranchIfCall(BranchInst *branch, Value *maybe_call) {
+static cl::opt<unsigned> HandlersTiming("handlers-timing",
+  cl::desc("Print the N slowest functions in the handlers pass"));
+
+void HandlersPass::addBranchIfCall(BranchInst *branch, Value *maybe_call, NamesPass &names) {
   assert(branch);
   assert(maybe_call);
 
-  NamesPass *names = &getAnalysis<NamesPass>();
-  
   if (CallInst *call = dyn_cast<CallInst>(maybe_call)) {
     Location loc = ep::getSource(branch);
     branches.push_back(loc);
@@ -19,7 +23,7 @@ void HandlersPass::addBranchIfCall(BranchInst *branch, Value *maybe_call) {
     Function *callee = call->getCalledFunction();
     if (callee) {
       returning_functions[loc] = callee->getName();
-      string branch_id = names->getStackName(*branch);
+      string branch_id = names.getStackName(*branch);
       string name = callee->getName();
       if (name.find(".") != string::npos) {
         name = name.substr(0, name.find("."));
@@ -29,82 +33,118 @@ void HandlersPass::addBranchIfCall(BranchInst *branch, Value *maybe_call) {
   }
 }
 
-void HandlersPass::fillEHVertices(Function &F) {
-  BranchSafetyPass *safety = &getAnalysis<BranchSafetyPass>();
-  PostDominatorTree *postdom = new PostDominatorTree();
-  NamesPass *names = &getAnalysis<NamesPass>();
+void HandlersPass::addReturningFunction(BranchInst *branch, NamesPass &names,
+                                        MemoryDependenceAnalysis &MDA, FunctionTiming &timing) {
+  if (branch->isUnconditional()) return;
+  Value *branch_op = branch->getOperand(0);
+  ICmpInst *icmp = dyn_cast<ICmpInst>(branch_op);
+  if (!icmp) return;
+  ++timing.branches;
+
+  Value *icmp_op0 = icmp->getOperand(0);
+  Value *icmp_op1 = icmp->getOperand(1);
+  addBranchIfCall(branch, icmp_op0, names);
+  addBranchIfCall(branch, icmp_op1, names);
+
+  if (LoadInst *load = dyn_cast<LoadInst>(icmp_op0)) {
+    // The pass manager has already run MDA on this function
+    ++timing.loads;
+    MemDepResult res = MDA.getDependency(load);
+    Instruction *dependency = res.getInst();
+    if (dependency) {
+      addBranchIfCall(branch, dependency, names);
+      if (StoreInst *store = dyn_cast<StoreInst>(dependency)) {
+        Value *sender = store->getOperand(0);
+        addBranchIfCall(branch, sender, names);
+      }
+    }
+  }
+}
 
+bool HandlersPass::fillEHVertices(BranchInst *branch, pair<BasicBlock*, BasicBlock*> branch_blocks,
+                                  NamesPass &names, PostDominatorTree &postdom) {
   // BranchSafety does not know about the FlowGraph, so we store the basic blocks
   // that are EH / NOT EH
-  // Then we go through and fill the vertices map
+  BasicBlock *not_handler_block = branch_blocks.first;
+  BasicBlock *handler_block = branch_blocks.second;
+
+  // Handler is the empty else branch - do nothing
+  if (postdom.dominates(handler_block, not_handler_block)) return false;
+
+  // Find where control flow merges again
+  BasicBlock *join_block = postdom.findNearestCommonDominator(handler_block, not_handler_block);
+  // No common post-dominator. Something funky going on.
+  // We have to skip this error-handling block
+  if (!join_block) return false;
+
+  string branch_id, not_handler_id, handler_on_id, handler_off_id;
+  branch_id = names.getStackName(*branch);
+  tie(not_handler_id, std::ignore)  = names.getBBNames(*not_handler_block);
+  tie(handler_on_id, std::ignore)   = names.getBBNames(*handler_block);
+  tie(handler_off_id, std::ignore)  = names.getBBNames(*join_block);
+
+  eh_vertices[branch_id] = make_tuple(not_handler_id, handler_on_id, handler_off_id);
+  handler_to_branch[handler_on_id] = branch_id;
+  handler_to_branch[handler_off_id] = branch_id;
+  handler_to_branch[not_handler_id] = branch_id;
+  return true;
+}
 
-  // Temporarily map by instruction until we can find which vertices are
-  map<Instruction*, tuple<FlowVertex*, FlowVertex*, FlowVertex*>> eh_instructions;
-  
+bool HandlersPass::runOnFunction(Function &F) {
+  auto start = chrono::steady_clock::now();
+
+  NamesPass &names = getAnalysis<NamesPass>();
+  BranchSafetyPass &safety = getAnalysis<BranchSafetyPass>();
+  MemoryDependenceAnalysis &MDA = getAnalysis<MemoryDependenceAnalysis>();
+  // Only built once a branch with a handler turns up
+  PostDominatorTree *postdom = nullptr;
+
+  FunctionTiming timing;
+  timing.function = F.getName().str();
+
+  // One sweep resolves both the tested call and the handler blocks of each branch
   for (inst_iterator I = inst_begin(F), E = inst_end(F); I != E; ++I) {
-    Instruction *inst = &*I;
-    if (BranchInst *branch = dyn_cast<BranchInst>(inst)) {
-      pair<BasicBlock*, BasicBlock*> branch_blocks = safety->getBranchBlocks(branch);
-      BasicBlock *not_handler_block = branch_blocks.first;
-      BasicBlock *handler_block = branch_blocks.second;
-      if (!handler_block) continue;
-
-      // Handler is the empty else branch - do nothing
-      postdom->runOnFunction(*handler_block->getParent());
-      if (postdom->dominates(handler_block, not_handler_block)) continue;
-
-      // Find where control flow merges again
-      BasicBlock *join_block = postdom->findNearestCommonDominator(handler_block, not_handler_block);
-      // No common post-dominator. Something funky going on.
-      // We have to skip this error-handling block
-      if (!join_block) return;
-
-      string branch_id, not_handler_id, handler_on_id, handler_off_id;
-      branch_id = names->getStackName(*branch);
-      tie(not_handler_id, std::ignore)  = names->getBBNames(*not_handler_block);
-      tie(handler_on_id, std::ignore)   = names->getBBNames(*handler_block);
-      tie(handler_off_id, std::ignore)  = names->getBBNames(*join_block);
-
-      eh_vertices[branch_id] = make_tuple(not_handler_id, handler_on_id, handler_off_id);
-      handler_to_branch[handler_on_id] = branch_id;
-      handler_to_branch[handler_off_id] = branch_id;
-      handler_to_branch[not_handler_id] = branch_id;      
+    BranchInst *branch = dyn_cast<BranchInst>(&*I);
+    if (!branch) continue;
+
+    addReturningFunction(branch, names, MDA, timing);
+
+    pair<BasicBlock*, BasicBlock*> branch_blocks = safety.getBranchBlocks(branch);
+    if (!branch_blocks.second) continue;
+    if (!postdom) {
+      postdom = &postdoms->get(F);
+    }
+    if (fillEHVertices(branch, branch_blocks, names, *postdom)) {
+      ++timing.handlers;
     }
   }
+
+  timing.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+  total_seconds += timing.seconds;
+  timings.push_back(std::move(timing));
+
+  return false;
 }
 
-bool HandlersPass::runOnFunction(Function &F) {
-  for (inst_iterator I = inst_begin(F), E = inst_end(F); I != E; ++I) {
-    Instruction *inst = &*I;           
-    if (BranchInst *branch = dyn_cast<BranchInst>(inst)) {
-      if (branch->isUnconditional()) continue;      
-      Value *branch_op = branch->getOperand(0);
-      ICmpInst *icmp = dyn_cast<ICmpInst>(branch_op);
-      if (!icmp) continue;
-      
-      Value *icmp_op0 = icmp->getOperand(0);
-      Value *icmp_op1 = icmp->getOperand(1);        
-      addBranchIfCall(branch, icmp_op0);
-      addBranchIfCall(branch, icmp_op1);
-
-      if (LoadInst *load = dyn_cast<LoadInst>(icmp_op0)) {
-        MemoryDependenceAnalysis &MDA = getAnalysis<MemoryDependenceAnalysis>();
-        MDA.runOnFunction(F);
-        MemDepResult res = MDA.getDependency(load);
-        Instruction *dependency = res.getInst();
-        if (dependency) {
-          addBranchIfCall(branch, dependency);
-          if (StoreInst *store = dyn_cast<StoreInst>(dependency)) {
-            Value *sender = store->getOperand(0);
-            addBranchIfCall(branch, sender);
-          }
-        }
-      }
-    }
+bool HandlersPass::doFinalization(Module &) {
+  if (HandlersTiming == 0) return false;
 
-    fillEHVertices(F);
+  vector<const FunctionTiming*> slowest;
+  for (const FunctionTiming &timing : timings) {
+    slowest.push_back(&timing);
+  }
+  size_t shown = min<size_t>(HandlersTiming, slowest.size());
+  partial_sort(slowest.begin(), slowest.begin() + shown, slowest.end(),
+               [](const FunctionTiming *a, const FunctionTiming *b) { return a->seconds > b->seconds; });
+
+  errs() << "HandlersPass: " << timings.size() << " functions in " << total_seconds << "s, "
+         << postdoms->builds() << " post-dominator trees built\n";
+  for (size_t i = 0; i < shown; ++i) {
+    const FunctionTiming &timing = *slowest[i];
+    errs() << "  " << timing.function << " " << timing.seconds << "s "
+           << timing.branches << " branches " << timing.loads << " loads "
+           << timing.handlers << " handlers\n";
   }
-  
   return false;
 }
 
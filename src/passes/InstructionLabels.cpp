@@ -10,7 +10,7 @@ static llvm::RegisterPass<InstructionLabelsPass> X("instruction-labels",
                                                    "Add per-instruction labels to the flowgraph", false, false);
 
 bool InstructionLabelsPass::runOnModule(Module &M) {
-  LabelVisitor LV(&getAnalysis<NamesPass>(), (&getAnalysis<ControlFlowPass>())->FG);
+  LabelVisitor LV(&getAnalysis<NamesPass>(), *getAnalysis<ControlFlowPass>().FG);
   LV.visit(M);
 
   label_to_id = LV.label_to_id;
@@ -23,7 +23,7 @@ void LabelVisitor::visitInstruction(llvm::Instruction &I) {
     return;
   }
 
-  flow_vertex_t vertex = FG.stack_vertex_map[names->getStackName(I)];
+  flow_vertex_t vertex = FG.getVertex(names->getStackKey(I));
   if (!vertex) return;
   string label = "F2V_INST_";
   label += I.getOpcodeName();
@@ -36,7 +36,7 @@ void LabelVisitor::visitBranchInst(llvm::BranchInst &I) {
     return;
   }
 
-  flow_vertex_t vertex = FG.stack_vertex_map[names->getStackName(I)];
+  flow_vertex_t vertex = FG.getVertex(names->getStackKey(I));
   FG.G[vertex].label_ids.push_back(getOrCreateId("F2V_CONDBR"));
 }
 
@@ -48,7 +48,7 @@ void LabelVisitor::visitStoreInst(llvm::StoreInst &I) {
 
   Value *sender = I.getOperand(0)->stripPointerCasts();
   vn_t sender_name = names->getVarName(sender);
-  flow_vertex_t vertex = FG.stack_vertex_map[names->getStackName(I)];
+  flow_vertex_t vertex = FG.getVertex(names->getStackKey(I));
   if (sender_name && sender_name->type == VarType::EC && sender_name->name() != "OK") {
     FG.G[vertex].label_ids.push_back(getOrCreateId("F2V_ERR_" + sender_name->name()));
   } else {
@@ -64,13 +64,13 @@ void LabelVisitor::visitReturnInst(llvm::ReturnInst &I) {
   Value *ret = I.getOperand(0)->stripPointerCasts();
   vn_t ret_name = names->getVarName(ret);
   if (ret_name && ret_name->type == VarType::EC && ret_name->name() != "OK") {
-    flow_vertex_t vertex = FG.stack_vertex_map[names->getStackName(I)];
+    flow_vertex_t vertex = FG.getVertex(names->getStackKey(I));
     FG.G[vertex].label_ids.push_back(getOrCreateId(ret_name->name()));
   }
 }
 
 void LabelVisitor::visitGetElementPtrInst(llvm::GetElementPtrInst &I) {
-  flow_vertex_t vertex = FG.stack_vertex_map[names->getStackName(I)];
+  flow_vertex_t vertex = FG.getVertex(names->getStackKey(I));
   if (I.getNumOperands() < 3) {
     FG.G[vertex].label_ids.push_back(getOrCreateId("F2V_INST_getelementptr"));
     return;
@@ -81,6 +81,25 @@ bool NamesPass::runOnModule(Module &M) {
     }
   }
 
+  // Number every function and instruction up front, in module order, so stack
+  // names do not depend on the order in which clients ask for them. After this
+  // the stack key getters only read, so ControlFlowPass can call them from
+  // several threads.
+  for (Module::iterator function = M.begin(), e = M.end(); function != e; ++function) {
+    if (function->isIntrinsic()) {
+      continue;
+    }
+    getFunctionId(*function);
+    if (function->isDeclaration()) {
+      continue;
+    }
+    for (BasicBlock &BB : *function) {
+      for (Instruction &I : BB) {
+        stack_iids[&I] = stack_cnt++;
+      }
+    }
+  }
+
   // Prepend function name to function arguments,
   // populate raw function names for function pointers
   // and add global return names
@@ -104,8 +123,8 @@ bool NamesPass::runOnModule(Module &M) {
 map<string, set<string>> NamesPass::get_bootstrap_functions() {
   map<string, set<string>> ret;
 
-  for (map<VarName, vn_t>::iterator i = memory_model.begin(), e = memory_model.end(); i != e; ++i) {
-    string idx = i->first.name();
+  for (auto i = memory_model.begin(), e = memory_model.end(); i != e; ++i) {
+    const string &idx = i->first;
     vn_t value = i->second;
 
     // TODO: Isolate string parsing somewhere
@@ -208,25 +227,46 @@ vn_t NamesPass::getVarName(const Value *V) {
   }
 
   // Something our analysis couldn't handle
-  if (names.find(stripped_V) == names.end()) {
+  auto it = names.find(stripped_V);
+  if (it == names.end()) {
     return nullptr;
   }
 
-  return names.at(stripped_V);
+  return it->second;
 }
 
 string NamesPass::getStackName(Instruction &I) {
-  string fname = I.getParent()->getParent()->getName();
-  string iid;
+  return stack_names->str(getStackKey(I));
+}
 
-  if (stack_iids.find(&I) != stack_iids.end()) {
-    iid = stack_iids[&I];
-  } else {
-    iid = to_string(stack_cnt++);
-    stack_iids[&I] = iid;
+stack_key_t NamesPass::getStackKey(Instruction &I) {
+  uint32_t fn = getFunctionId(*I.getParent()->getParent());
+  return StackNameTable::makeKey(StackKind::INST, fn, getInstructionId(I));
+}
+
+uint32_t NamesPass::getFunctionId(const Function &F) {
+  auto it = function_ids.find(&F);
+  if (it != function_ids.end()) {
+    return it->second;
+  }
+  uint32_t id = stack_names->addFunction(F.getName().str());
+  function_ids[&F] = id;
+  return id;
+}
+
+// Instructions not seen by runOnModule are numbered on first use
+unsigned NamesPass::getInstructionId(const Instruction &I) {
+  auto it = stack_iids.find(&I);
+  if (it != stack_iids.end()) {
+    return it->second;
   }
+  unsigned iid = stack_cnt++;
+  stack_iids[&I] = iid;
+  return iid;
+}
 
-  return fname + "." + iid;
+shared_ptr<StackNameTable> NamesPass::getStackNames() const {
+  return stack_names;
 }
 
 string NamesPass::getDummyName(Instruction *I) {
@@ -237,20 +277,26 @@ string NamesPass::getDummyName(Instruction *I) {
 // Basic blocks are named by the iid of their first instruction
 // bbe is appended for the entry point and bbx for the exit
 pair<string, string> NamesPass::getBBNames(BasicBlock &BB) {
-  pair<string, string> names;
+  stack_key_t bb_enter, bb_exit;
+  tie(bb_enter, bb_exit) = getBBKeys(BB);
+  return make_pair(stack_names->str(bb_enter), stack_names->str(bb_exit));
+}
 
+pair<stack_key_t, stack_key_t> NamesPass::getBBKeys(BasicBlock &BB) {
   Instruction &front = BB.front();
-  string bb_enter = getStackName(front) + "bbe";
-  string bb_exit = getStackName(front) + "bbx";
-
-  names = make_pair(bb_enter, bb_exit);
-  return names;
+  uint32_t fn = getFunctionId(*BB.getParent());
+  unsigned iid = getInstructionId(front);
+  return make_pair(StackNameTable::makeKey(StackKind::BBE, fn, iid),
+                   StackNameTable::makeKey(StackKind::BBX, fn, iid));
 }
 
 // Call names are just plain strings (stack locations)
 string NamesPass::getCallName(Function &F) {
-  string fname = F.getName();
-  return fname + ".0";
+  return stack_names->str(getCallKey(F));
+}
+
+stack_key_t NamesPass::getCallKey(Function &F) {
+  return StackNameTable::makeKey(StackKind::INST, getFunctionId(F), 0);
 }
 
 // Get the names of the functions that are called by this instruction
@@ -357,7 +403,7 @@ void NamesPass::updateMemory(MemoryName index, vn_t update) {
     return;
   }
 
-  vn_t backing_name = memory_model[index];
+  vn_t backing_name = memory_model[index.name()];
 
   mul_t update_mul = nullptr;
   mul_t backing_mul = nullptr;
@@ -378,7 +424,7 @@ void NamesPass::updateMemory(MemoryName index, vn_t update) {
     backing_mul->insert(update);
   } else if (update_mul && !backing_mul && backing_name) {
     update_mul->insert(backing_name);
-    memory_model[index] = update_mul;
+    memory_model[index.name()] = update_mul;
   } else if (update->type == VarType::FUNCTION && backing_name && update->name() != backing_name->name()) {
     // Where MultiNames are created, only handle functions for now
     // Removing the VarType::FUNCTION filter above will require adjustiing
@@ -386,18 +432,19 @@ void NamesPass::updateMemory(MemoryName index, vn_t update) {
     mul_t multi = make_shared<MultiName>();
     multi->insert(backing_name);
     multi->insert(update);
-    memory_model[index] = multi;
+    memory_model[index.name()] = multi;
 
   } else {
-    memory_model[index] = update;
+    memory_model[index.name()] = update;
   }
 }
 
 mem_t NamesPass::getLoadIndex(const Value *v) const {
-  if (load_index.find(v) == load_index.end()) {
+  auto it = load_index.find(v);
+  if (it == load_index.end()) {
     return nullptr;
   }
-  return load_index.at(v);
+  return it->second;
 }
 
 // Name of load instruction is the name of what it loads
@@ -422,9 +469,10 @@ void NamesPass::visitLoadInst(LoadInst &I) {
     mem_t gep_mem = static_pointer_cast<MemoryName>(gep_name);
 
     // Need to look up backing VarName
-    if (memory_model.find(*gep_mem) != memory_model.end()) {
+    auto backing = memory_model.find(gep_mem->name());
+    if (backing != memory_model.end()) {
       // We already have the backing name
-      names[&I] = memory_model.at(*gep_mem);
+      names[&I] = backing->second;
       load_index[&I] = gep_mem;
       vn_t vn = names[&I];
     } else if (GlobalValue *gv = module->getNamedValue(gep_mem->base_name)) {
@@ -443,9 +491,12 @@ void NamesPass::visitLoadInst(LoadInst &I) {
       GetElementPtrInst *gep_inst = dyn_cast<GetElementPtrInst>(from);
       mem_t index = getApproxName(*gep_inst);
 
-      if (index && memory_model.find(*index) != memory_model.end()) {
-        names[&I] = memory_model.at(*index);
-        load_index[&I] = index;
+      if (index) {
+        auto approx = memory_model.find(index->name());
+        if (approx != memory_model.end()) {
+          names[&I] = approx->second;
+          load_index[&I] = index;
+        }
       }
     }
   } else {
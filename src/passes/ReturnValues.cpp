@@ -55,11 +55,11 @@ void ReturnValuesPass::runOnFunction(Function &F) {
   ControlFlowPass &cfp = getAnalysis<ControlFlowPass>();
   
   // Mark nodes in control flow graph
-  BGL_FORALL_VERTICES(v, cfp.FG.G, _FlowGraph) {
-    if (inst_write_to_returns.find(cfp.FG.G[v].I) != inst_write_to_returns.end()) {
-      cerr << cfp.FG.G[v].stack << " IS RETURN WRITE\n";
+  BGL_FORALL_VERTICES(v, cfp.FG->G, _FlowGraph) {
+    if (inst_write_to_returns.find(cfp.FG->G[v].I) != inst_write_to_returns.end()) {
+      cerr << cfp.FG->G[v].stack << " IS RETURN WRITE\n";
       cerr << v << endl;
-      write_to_return.insert(cfp.FG.G[v].stack);
+      write_to_return.insert(cfp.FG->G[v].stack);
     }
   }
 }
@@ -1,69 +1,138 @@
 #include "TraceDatabase.hpp"
 #include <iostream>
-#include <sstream>
+#include <set>
 
 using namespace std;
 
-TraceDatabase::TraceDatabase(string path) {
+bool TraceDatabaseOptions::validJournalMode() const {
+  static const set<string> modes = {"DELETE", "TRUNCATE", "PERSIST", "MEMORY", "WAL", "OFF"};
+  return modes.find(journal_mode) != modes.end();
+}
+
+TraceDatabase::TraceDatabase(string path, const TraceDatabaseOptions &options) {
   int err = sqlite3_open(path.c_str(), &db);
   if (err) {
     cerr << "FATAL ERROR: Unable to open/create database file" << endl;
     abort();
   }
 
+  setPragmas(options);
+
   if (!isInitialized()) {
     initialize();
   }
 
+  insert_handler = prepare("INSERT INTO Handler (stack, predicate_loc, parent_function) VALUES (?, ?, ?);");
+  insert_context = prepare("INSERT INTO Context (handler, item, type, tactic) VALUES (?, ?, ?, ?);");
+  insert_response = prepare("INSERT INTO Response (handler, item, type, tactic) VALUES (?, ?, ?, ?);");
+  insert_nesting = prepare("INSERT OR IGNORE INTO Nesting (parent_handler, child_handler) VALUES (?, ?);");
+
   sqlite3_exec(db, "BEGIN TRANSACTION", NULL, NULL, NULL);
+  load_start = chrono::steady_clock::now();
 }
 
 TraceDatabase::~TraceDatabase() {
-  sqlite3_exec(db, "COMMIT TRANSACTION", NULL, NULL, NULL);
+  finish();
+  sqlite3_finalize(insert_handler);
+  sqlite3_finalize(insert_context);
+  sqlite3_finalize(insert_response);
+  sqlite3_finalize(insert_nesting);
   sqlite3_close(db);
 }
 
-void TraceDatabase::addTraceActions(const sqlite3_int64 row_id, const Trace &trace) {
-  int err = 0;
+void TraceDatabase::finish() {
+  if (finished) {
+    return;
+  }
+  finished = true;
+
+  char *errMsg = nullptr;
+  int err = sqlite3_exec(db, "COMMIT TRANSACTION", NULL, NULL, &errMsg);
+  checkResult(err, errMsg);
+  auto load_end = chrono::steady_clock::now();
+
+  // Cheaper to build once than to maintain during the load
+  err = sqlite3_exec(db,
+                     "CREATE INDEX IF NOT EXISTS ContextHandler ON Context(handler);"
+                     "CREATE INDEX IF NOT EXISTS ResponseHandler ON Response(handler);",
+                     NULL, NULL, &errMsg);
+  checkResult(err, errMsg);
+  auto index_end = chrono::steady_clock::now();
+
+  double load_seconds = chrono::duration<double>(load_end - load_start).count();
+  double index_seconds = chrono::duration<double>(index_end - load_end).count();
+  cerr << "Wrote " << rows << " rows in " << load_seconds << "s";
+  if (load_seconds > 0) {
+    cerr << " (" << (size_t) (rows / load_seconds) << " rows/s)";
+  }
+  cerr << ", indexed in " << index_seconds << "s" << endl;
+}
+
+void TraceDatabase::setPragmas(const TraceDatabaseOptions &options) {
+  if (!options.validJournalMode()) {
+    cerr << "FATAL ERROR: Invalid journal mode: " << options.journal_mode << endl;
+    sqlite3_close(db);
+    abort();
+  }
+
+  string query = "PRAGMA journal_mode=" + options.journal_mode + ";";
+  query += string("PRAGMA synchronous=") + (options.synchronous ? "NORMAL" : "OFF") + ";";
+  // Negative sizes are in KiB
+  query += "PRAGMA cache_size=-" + to_string((uint64_t) options.cache_mb * 1024) + ";";
+  query += "PRAGMA temp_store=MEMORY;";
+
   char *errMsg = nullptr;
+  int err = sqlite3_exec(db, query.c_str(), NULL, NULL, &errMsg);
+  checkResult(err, errMsg);
+}
+
+sqlite3_stmt* TraceDatabase::prepare(const char *query) {
+  sqlite3_stmt *stmt = nullptr;
+  int err = sqlite3_prepare_v2(db, query, -1, &stmt, nullptr);
+  checkResult(err, nullptr);
+  return stmt;
+}
+
+void TraceDatabase::bindText(sqlite3_stmt *stmt, int index, const string &text) {
+  int err = sqlite3_bind_text(stmt, index, text.data(), text.size(), SQLITE_STATIC);
+  checkResult(err, nullptr);
+}
+
+void TraceDatabase::step(sqlite3_stmt *stmt) {
+  int err = sqlite3_step(stmt);
+  if (err != SQLITE_DONE) {
+    checkResult(err, nullptr);
+  }
+  sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+  ++rows;
+}
 
+void TraceDatabase::insertItem(sqlite3_stmt *stmt, const sqlite3_int64 row_id, const Item &item) {
+  const string type = item.getType();
+  checkResult(sqlite3_bind_int64(stmt, 1, row_id), nullptr);
+  bindText(stmt, 2, item.name);
+  bindText(stmt, 3, type);
+  bindText(stmt, 4, item.tactic);
+  step(stmt);
+}
+
+void TraceDatabase::addTraceActions(const sqlite3_int64 row_id, const Trace &trace) {
   for (const Item& i : trace.contexts) {
-    ostringstream item_query;
-    item_query << "INSERT INTO Context (handler, item, type, tactic) VALUES ("
-               << row_id  << ","
-               << "'" << i.name <<  "',"
-               << "'" << i.getType() << "',"
-               << "'" << i.tactic << "'"
-               << ");";
-
-    err = sqlite3_exec(db, item_query.str().c_str(), NULL, NULL, NULL);
-    checkResult(err, errMsg);
+    insertItem(insert_context, row_id, i);
   }
 
   for (const Item& i : trace.items) {
-    ostringstream item_query;
-    item_query << "INSERT INTO Response (handler, item, type, tactic) VALUES ("
-               << row_id  << ","
-               << "'" << i.name <<  "',"
-               << "'" << i.getType() << "',"
-               << "'" << i.tactic << "'"
-               << ");";
-
-    err = sqlite3_exec(db, item_query.str().c_str(), NULL, NULL, NULL);
-    checkResult(err, errMsg);
+    insertItem(insert_response, row_id, i);
   }
 }
 
-// TODO: Filter queries for injection
 sqlite3_int64 TraceDatabase::addHandlerTrace(const Trace &trace) {
-  ostringstream query;
-  query << "INSERT INTO Handler (stack, predicate_loc, parent_function) VALUES ('"
-        << trace.stack_id << "','"
-        << trace.location << "','"
-        << trace.parent_function << "');";
-  char *errMsg = nullptr;
-  int err = sqlite3_exec(db, query.str().c_str(), NULL, NULL, NULL);
-  checkResult(err, errMsg);
+  const string location = trace.location.str();
+  bindText(insert_handler, 1, trace.stack_id);
+  bindText(insert_handler, 2, location);
+  bindText(insert_handler, 3, trace.parent_function);
+  step(insert_handler);
 
   sqlite3_int64 trace_rowid = sqlite3_last_insert_rowid(db);
   addTraceActions(trace_rowid, trace);
@@ -78,6 +147,12 @@ void TraceDatabase::addPostActionTrace(const sqlite3_int64 handler_id, const Pos
   addTraceActions(handler_id, trace);
 }
 
+void TraceDatabase::addNested(const sqlite3_int64 parent_id, const sqlite3_int64 child_id) {
+  checkResult(sqlite3_bind_int64(insert_nesting, 1, parent_id), nullptr);
+  checkResult(sqlite3_bind_int64(insert_nesting, 2, child_id), nullptr);
+  step(insert_nesting);
+}
+
 void TraceDatabase::checkResult(int err, char *errMsg) {
   if (err != SQLITE_OK) {
     cerr << sqlite3_errmsg(db) << endl;
@@ -101,9 +176,9 @@ void TraceDatabase::initialize() {
 }
 
 bool TraceDatabase::isInitialized() {
-  // We just check to see if the trace table exists.
+  // We just check to see if the handler table exists.
   // This doesn't handle situations where the schema is corrupt / old
-  string query = "SELECT name FROM sqlite_master WHERE type='table' and name='Trace';";
+  string query = "SELECT name FROM sqlite_master WHERE type='table' and name='Handler';";
   bool initialized = false;
   int (*callback)(void*, int, char**, char**) =
     [](void* initialized, int, char**, char**) {
@@ -2,12 +2,26 @@
 #define TRACEDATABASE_HPP
 
 #include <sqlite3.h>
+#include <chrono>
 #include <string>
 #include "Traces.hpp"
 
+// Pragmas for the bulk load. The database is rebuilt from the bitcode on every
+// run, so by default durability is traded for speed.
+struct TraceDatabaseOptions {
+  // DELETE, TRUNCATE, PERSIST, MEMORY, WAL or OFF
+  std::string journal_mode = "OFF";
+  bool synchronous = false;
+  // Page cache size in MiB
+  unsigned cache_mb = 256;
+
+  // journal_mode is pasted into a PRAGMA, so only the modes above are accepted
+  bool validJournalMode() const;
+};
+
 class TraceDatabase {
 public:
-  TraceDatabase(std::string path);
+  TraceDatabase(std::string path, const TraceDatabaseOptions &options = TraceDatabaseOptions());
   ~TraceDatabase();
 
   // Returns id of trace used in database
@@ -18,8 +32,22 @@ public:
   void addPostActionTrace(const sqlite3_int64 handler_id, const PostActionTrace &trace);
   void addNested(const sqlite3_int64 parent_id, const sqlite3_int64 child_id);
 
+  // Commit the load, then index the action tables by handler. Called by the
+  // destructor if it was not called before.
+  void finish();
+
 private:
   sqlite3 *db = nullptr;
+  bool finished = false;
+
+  // Prepared once, reset after every row
+  sqlite3_stmt *insert_handler = nullptr;
+  sqlite3_stmt *insert_context = nullptr;
+  sqlite3_stmt *insert_response = nullptr;
+  sqlite3_stmt *insert_nesting = nullptr;
+
+  size_t rows = 0;
+  std::chrono::steady_clock::time_point load_start;
 
   // Check to see if the schema has been initialized
   bool isInitialized();
@@ -27,9 +55,21 @@ private:
   // Create the schema
   void initialize();
 
+  void setPragmas(const TraceDatabaseOptions &options);
+
+  sqlite3_stmt* prepare(const char *query);
+
   // pre is set to false for normal handler actions, true for pre-actions
   void addTraceActions(const sqlite3_int64 row_id, const Trace &trace);
 
+  void insertItem(sqlite3_stmt *stmt, const sqlite3_int64 row_id, const Item &item);
+
+  // Bind text that outlives the next step of stmt
+  void bindText(sqlite3_stmt *stmt, int index, const std::string &text);
+
+  // Run a prepared insert and reset it for the next row
+  void step(sqlite3_stmt *stmt);
+
   // Make sure err is SQLITE_OK
   void checkResult(int err, char* errMsg);
 
@@ -4,6 +4,7 @@
 #include "Location.hpp"
 #include "Utility.hpp"
 #include "TraceDatabase.hpp"
+#include "Parallel.hpp"
 #include <llvm/IR/Instructions.h>
 #include <iostream>
 #include <stack>
@@ -15,12 +16,12 @@ using namespace std;
 using namespace ep;
 using namespace llvm;
 
-Traces::Traces(ControlFlowPass *control_flow, string db_path,
-    BranchSafetyPass *safety, NamesPass *names, PostDominatorTree *postdom) :
-      control_flow(control_flow), FG(control_flow->FG),
-      db_path(db_path), safety(safety), names(names), postdom(postdom) {}
+Traces::Traces(unique_ptr<FlowGraph> flow_graph, string db_path,
+    BranchSafetyPass *safety, NamesPass *names, shared_ptr<PostDomCache> postdoms) :
+      owned_FG(std::move(flow_graph)), FG(*owned_FG),
+      db_path(db_path), safety(safety), names(names), postdoms(std::move(postdoms)) {}
 
-void Traces::initialize() {
+void Traces::initialize(unsigned threads) {
   flow_vertex_iter vi, vi_end;
   for (tie(vi, vi_end) = vertices(FG.G); vi != vi_end; ++vi) {
     FlowVertex v = FG.G[*vi];
@@ -31,20 +32,33 @@ void Traces::initialize() {
       resolveBlock(v);
     }
   }
+  cerr << "Resolved hints with " << postdoms->builds() << " post-dominator trees for "
+       << postdoms->lookups() << " lookups\n";
 
+  vector<flow_vertex_t> handlers;
   for (tie(vi, vi_end) = vertices(FG.G); vi != vi_end; ++vi) {
-    FlowVertex vtx = FG.G[*vi];
-    auto stop = handlers_stop.find(vtx.stack);
-    if (stop != handlers_stop.end()) {
-      std::pair<PreActionTrace, PostActionTrace> pre_post = collectPrePostActions(*vi);
-      pre_actions.emplace(stop->first, std::get<0>(pre_post));
-      post_actions.emplace(stop->first, std::get<1>(pre_post));
+    if (handlers_stop.find(FG.G[*vi].stack) != handlers_stop.end()) {
+      handlers.push_back(*vi);
     }
   }
+
+  // Handlers are independent. Each task has its own mappers and discovered
+  // sets, and only reads the graph and the names.
+  vector<unique_ptr<pair<PreActionTrace, PostActionTrace>>> collected(handlers.size());
+  parallel_for(handlers.size(), threads, [&](size_t i) {
+    collected[i].reset(new pair<PreActionTrace, PostActionTrace>(collectPrePostActions(handlers[i])));
+  });
+
+  // In vertex order, so the first handler with a stack wins as before
+  for (size_t i = 0; i < handlers.size(); ++i) {
+    const string &stack = FG.G[handlers[i]].stack;
+    pre_actions.emplace(stack, std::move(collected[i]->first));
+    post_actions.emplace(stack, std::move(collected[i]->second));
+  }
 }
 
-std::ostream& Traces::generate(std::ostream &OS) const {
-  TraceDatabase TD(db_path);
+std::ostream& Traces::generate(std::ostream &OS, const TraceDatabaseOptions &db_options) const {
+  TraceDatabase TD(db_path, db_options);
   map<string, sqlite3_int64> handler_row_ids;
 
   for (const auto &pair : pre_actions) {
@@ -68,11 +82,12 @@ std::ostream& Traces::generate(std::ostream &OS) const {
     const PostActionTrace &post_trace = post_iter->second;
     TD.addPostActionTrace(handler_id, post_trace);
   }
+  TD.finish();
 
   return OS;
 }
 
-std::pair<PreActionTrace, PostActionTrace> Traces::collectPrePostActions(flow_vertex_t handler) {
+std::pair<PreActionTrace, PostActionTrace> Traces::collectPrePostActions(flow_vertex_t handler) const {
   llvm::Function *F = FG.G[handler].F;
   StandardActionMapper pre_mapper(names, "PRE");
   StandardActionMapper post_mapper(names, "POST");
@@ -81,9 +96,14 @@ std::pair<PreActionTrace, PostActionTrace> Traces::collectPrePostActions(flow_ve
 
   PreActionTrace pre_trace(handler_stack);
   PreActionVisitor pre_vis(pre_mapper, pre_trace.contexts);
-  DepthFirstVisitor<_FlowGraph> pre_dfs(pre_vis);
-  flow_vertex_t fnVertex = control_flow->getFunctionVertex(F);
-  pre_trace.location = handler2pred[handler_stack];
+  DepthFirstVisitor<_FlowGraph> pre_dfs(pre_vis, enumerate_between ?
+                                        DepthFirstVisitor<_FlowGraph>::Between::ENUMERATE :
+                                        DepthFirstVisitor<_FlowGraph>::Between::SWEEP);
+  flow_vertex_t fnVertex = FG.getVertex(names->getCallKey(*F));
+  auto pred = handler2pred.find(handler_stack);
+  if (pred != handler2pred.end()) {
+    pre_trace.location = pred->second;
+  }
   pre_trace.parent_function = handler_stack.substr(0, handler_stack.find('.'));
 
   pre_dfs.visit(fnVertex, handler, FG.G);
@@ -120,11 +140,11 @@ void Traces::resolveBlock(const FlowVertex &V) {
     }
 
     // Handler is the empty else branch - do nothing
-    postdom->runOnFunction(*handler_block->getParent());
-    if (postdom->dominates(handler_block, not_handler_block)) return;
+    PostDominatorTree &postdom = postdoms->get(*handler_block->getParent());
+    if (postdom.dominates(handler_block, not_handler_block)) return;
 
     // Find where control flow merges again
-    BasicBlock *join_block = postdom->findNearestCommonDominator(handler_block, not_handler_block);
+    BasicBlock *join_block = postdom.findNearestCommonDominator(handler_block, not_handler_block);
     if (!join_block) continue;
 
     DILocation *loc = terminator->getDebugLoc();
@@ -158,11 +178,11 @@ void Traces::resolveBranch(const FlowVertex &V) {
   if (!handler_block) return;
 
   // Handler is the empty else branch - do nothing
-  postdom->runOnFunction(*handler_block->getParent());
-  if (postdom->dominates(handler_block, not_handler_block)) return;
+  PostDominatorTree &postdom = postdoms->get(*handler_block->getParent());
+  if (postdom.dominates(handler_block, not_handler_block)) return;
 
   // Find where control flow merges again
-  BasicBlock *join_block = postdom->findNearestCommonDominator(handler_block, not_handler_block);
+  BasicBlock *join_block = postdom.findNearestCommonDominator(handler_block, not_handler_block);
 
   string handler_stack;
   tie(handler_stack, std::ignore) = names->getBBNames(*handler_block);
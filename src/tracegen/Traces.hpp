@@ -9,7 +9,7 @@
 #include "Names.hpp"
 #include "ControlFlow.hpp"
 #include "HandlersPass.hpp"
-#include "llvm/Analysis/PostDominators.h"
+#include "PostDomCache.hpp"
 #include <boost/graph/reverse_graph.hpp>
 #include <set>
 #include <unordered_set>
@@ -77,17 +77,20 @@ public:
 
 };
 
+struct TraceDatabaseOptions;
+
 class Traces {
 public:
   // Uses a DataflowResult (such as from DataflowWali, the "lightweight" analysis)
-  Traces(ControlFlowPass *control_flow, std::string db_path,
-	 BranchSafetyPass *safety, NamesPass *names, llvm::PostDominatorTree *postdom);
+  // Takes ownership of the ICFG, either released by ControlFlowPass or read from the graph cache
+  Traces(std::unique_ptr<FlowGraph> flow_graph, std::string db_path,
+	 BranchSafetyPass *safety, NamesPass *names, std::shared_ptr<ep::PostDomCache> postdoms);
 
   /// \brief Print the traces in a human readable format
   std::ostream& format(std::ostream &OS) const;
 
   /// \brief Actually create the traces.
-  std::ostream& generate(std::ostream &OS) const;
+  std::ostream& generate(std::ostream &OS, const TraceDatabaseOptions &db_options) const;
 
   /// \brief Read the list of error-handling hints from a file.
   ///
@@ -101,19 +104,24 @@ public:
   /// it is not necessary to guess the error handling direction.
   void read_handlers(string preds_path);
 
+  /// Find pre-action vertices with the old branch enumerator instead of the
+  /// two reachability sweeps. Only for comparing results.
+  bool enumerate_between = false;
+
   /// \brief Setup routine for the trace generator.
   ///
   /// This must be called after read_predicates and before generate.
-  void initialize();
+  /// Handler actions are collected on up to threads workers.
+  void initialize(unsigned threads = 1);
 
 private:
-  ControlFlowPass *control_flow;
+  std::unique_ptr<FlowGraph> owned_FG;
   FlowGraph &FG;
   std::string db_path;
 
   BranchSafetyPass *safety;
   NamesPass *names;
-  llvm::PostDominatorTree *postdom;
+  std::shared_ptr<ep::PostDomCache> postdoms;
 
   /// \brief The pre-actions (intraprocedural context) for each error-handler.
   ///
@@ -159,7 +167,8 @@ private:
   void resolveBlock(const FlowVertex &V);
 
   Trace collectHandlerActions(flow_vertex_t start, string stop, const HandlersPass *handlerspass);
-  std::pair<PreActionTrace, PostActionTrace> collectPrePostActions(flow_vertex_t handler);
+  /// Safe to call concurrently: only reads the graph, the names and handler2pred
+  std::pair<PreActionTrace, PostActionTrace> collectPrePostActions(flow_vertex_t handler) const;
 };
 
 #endif
@@ -2,6 +2,10 @@
 #include "BranchSafety.hpp"
 #include "Traces.hpp"
 #include "HandlersPass.hpp"
+#include "InstructionLabels.hpp"
+#include "GraphCache.hpp"
+#include "TraceDatabase.hpp"
+#include "Parallel.hpp"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
@@ -9,26 +13,71 @@
 #include "llvm/Pass.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/SourceMgr.h"
-#include "llvm/Analysis/PostDominators.h"
+#include "PostDomCache.hpp"
 #include "llvm/Analysis/MemoryDependenceAnalysis.h"
+#include <algorithm>
+#include <getopt.h>
+#include <sstream>
 #include <unistd.h>
 
 using namespace llvm;
 using namespace std;
+using namespace p2v;
 
 void usage() {
   cerr << "Usage: " << "tracegen -e <codes file> -b <bitcode file> [-d dbfile] [-i handlers file]\n";
   cerr << "-d to write results to sqlite database\n";
+  cerr << "-j <threads> to collect handler actions in parallel (0 = all cores, default 1). Output is the same.\n";
+  cerr << "--cache-dir <dir> to reuse the ICFG between runs on the same inputs\n";
+  cerr << "--enumerate-between to find pre-actions with the old path enumerator, to compare results\n";
+  cerr << "--journal-mode <mode> sqlite journal mode for the load: OFF (default), WAL, DELETE, TRUNCATE, PERSIST or MEMORY\n";
+  cerr << "--synchronous to keep sqlite syncing to disk during the load\n";
+  cerr << "--cache-mb <MiB> sqlite page cache size (default 256)\n";
 }
 
 int main(int argc, char **argv) {
-  string bitcode_path, ec_path, db_path, handlers_path;
+  string bitcode_path, ec_path, db_path, handlers_path, cache_dir;
   bool ec_context       = false;
+  TraceDatabaseOptions db_options;
+  unsigned threads = 1;
+  bool enumerate_between = false;
+
+  static const struct option long_options[] = {
+    {"cache-dir", required_argument, nullptr, 'C'},
+    {"journal-mode", required_argument, nullptr, 'J'},
+    {"synchronous", no_argument, nullptr, 'S'},
+    {"enumerate-between", no_argument, nullptr, 'E'},
+    {"cache-mb", required_argument, nullptr, 'M'},
+    {nullptr, 0, nullptr, 0}
+  };
 
   int c;
 
-  while ((c = getopt(argc, argv, "e:c:b:d:p:i:")) != EOF) {
+  while ((c = getopt_long(argc, argv, "e:c:b:d:p:i:j:", long_options, nullptr)) != EOF) {
     switch (c) {
+    case 'C':
+      cache_dir = optarg;
+      break;
+    case 'J':
+      db_options.journal_mode = optarg;
+      transform(db_options.journal_mode.begin(), db_options.journal_mode.end(),
+                db_options.journal_mode.begin(), ::toupper);
+      break;
+    case 'S':
+      db_options.synchronous = true;
+      break;
+    case 'E':
+      enumerate_between = true;
+      break;
+    case 'M': {
+      istringstream ss(optarg);
+      ss >> db_options.cache_mb;
+      if (ss.fail()) {
+        usage();
+        return 1;
+      }
+      break;
+    }
     case 'e':
       ec_path = optarg;
       break;
@@ -41,6 +90,16 @@ int main(int argc, char **argv) {
     case 'i':
       handlers_path = optarg;
       break;
+    case 'j': {
+      istringstream ss(optarg);
+      ss >> threads;
+      if (ss.fail()) {
+        usage();
+        return 1;
+      }
+      threads = ep::resolve_threads(threads);
+      break;
+    }
     case ':':
     case '?':
       usage();
@@ -60,6 +119,10 @@ int main(int argc, char **argv) {
     usage();
     return 1;
   }
+  if (!db_options.validJournalMode()) {
+    usage();
+    return 1;
+  }
 
   SMDiagnostic Err;
   std::unique_ptr<Module> Mod(parseIRFile(bitcode_path, Err, getGlobalContext()));
@@ -69,6 +132,17 @@ int main(int argc, char **argv) {
     return 1;
   }
 
+  // On a cache hit only ControlFlowPass is skipped, the other passes need the IR anyway
+  string cache_path;
+  GraphCacheMeta meta;
+  unique_ptr<FlowGraph> FG;
+  if (!cache_dir.empty()) {
+    cache_path = graph_cache_path(cache_dir, bitcode_path, ec_path, false);
+  }
+  if (!cache_path.empty()) {
+    FG = read_graph_cache(cache_path, meta);
+  }
+
   legacy::PassManager PM;
   NamesPass *names = new NamesPass(ec_path);
   PM.add(names);
@@ -76,11 +150,18 @@ int main(int argc, char **argv) {
   BranchSafetyPass *safety = new BranchSafetyPass();
   PM.add(safety);
 
-  ControlFlowPass *cfp = new ControlFlowPass();
-  PM.add(cfp);
+  ControlFlowPass *cfp = nullptr;
+  InstructionLabelsPass *ilp = nullptr;
+  if (!FG) {
+    cfp = new ControlFlowPass();
+    PM.add(cfp);
 
-  PostDominatorTree *postdom = new PostDominatorTree();
-  PM.add(postdom);
+    // The cache is shared with getgraph and pathgen, which need the labels
+    if (!cache_path.empty()) {
+      ilp = new InstructionLabelsPass();
+      PM.add(ilp);
+    }
+  }
 
   MemoryDependenceAnalysis *mda = new MemoryDependenceAnalysis();
   PM.add(mda);
@@ -88,12 +169,31 @@ int main(int argc, char **argv) {
   cerr << "Running frontend passes...\n";
   PM.run(*Mod);
 
-  Traces traces(cfp, db_path, safety, names, postdom);
+  if (FG) {
+    bind_graph_to_module(*FG, *Mod, *names, meta);
+  } else {
+    FG = cfp->releaseFlowGraph();
+    if (ilp) {
+      for (const auto &kv : ilp->label_to_id) {
+        meta.id_to_label[kv.second] = kv.first;
+      }
+      meta.bootstrap_fns = names->get_bootstrap_functions();
+      meta.cross_folder_pruned = cfp->cross_folder_pruned;
+      if (!write_graph_cache(cache_path, *FG, meta)) {
+        cerr << "WARNING: Could not write graph cache " << cache_path << endl;
+      }
+    }
+  }
+
+  // Built per function on demand instead of by the pass manager for every function
+  auto postdoms = make_shared<ep::PostDomCache>();
+  Traces traces(std::move(FG), db_path, safety, names, postdoms);
+  traces.enumerate_between = enumerate_between;
   traces.read_handlers(handlers_path);
-  traces.initialize();
+  traces.initialize(threads);
 
   cerr << "Writing traces...\n";
-  traces.generate(cout);
+  traces.generate(cout, db_options);
 
   return 0;
 }
@@ -3,10 +3,15 @@ import logging
 import itertools
 import os
 import subprocess
-from collections import defaultdict
-import edgelist_pb2    # protobuf
+import sys
+import importlib
+from collections import defaultdict, namedtuple
 import networkx as nx
 
+# Protobuf bindings for edgelist.proto. The build generates edgelist_pb2.py next to
+# getgraph with the same protoc, so it is imported from there by load_edgelist_bindings.
+edgelist_pb2 = None
+
 class PushDown:
     class StackDistance:
         def __init__(self, calls, returns):
@@ -234,11 +239,29 @@ class PushDown:
 
         assert False
 
+def load_edgelist_bindings(build_dir):
+    """
+    Imports edgelist_pb2 from the build directory that holds getgraph
+    :param build_dir: Directory that CMake generated edgelist_pb2.py into
+    """
+    global edgelist_pb2
+    if edgelist_pb2 is not None:
+        return
+    if not os.path.isfile(os.path.join(build_dir, 'edgelist_pb2.py')):
+        raise Exception(
+            'Unable to find edgelist_pb2.py in %s. It is generated by the CMake build next to getgraph.' % build_dir)
+    sys.path.insert(0, build_dir)
+    try:
+        edgelist_pb2 = importlib.import_module('edgelist_pb2')
+    finally:
+        sys.path.remove(build_dir)
+
+
 def generate_edgelist(bitcode_path, getgraph_binary, error_codes, remove_labels=None, remove_cross_folder=False):
     """
     Uses getgraph to generate an edgelist
     :param bitcode_path:
-    :return: A list of edge tuples of the form (u, v, label, location)
+    :return: A StreamedEdgelist. Edges are decoded while getgraph is still writing them.
     """
     if not os.path.isfile(bitcode_path):
         raise Exception('Unable to find bitcode file %s' % bitcode_path)
@@ -249,6 +272,7 @@ def generate_edgelist(bitcode_path, getgraph_binary, error_codes, remove_labels=
     if not os.path.isfile(getgraph_binary):
         raise Exception(
             'Unable to find getgraph at %s. You can use --getgraph to specify the location.' % getgraph_binary)
+    load_edgelist_bindings(os.path.dirname(os.path.abspath(getgraph_binary)))
 
     getgraph_cmd = [getgraph_binary,
                     '--edgelist',
@@ -262,31 +286,88 @@ def generate_edgelist(bitcode_path, getgraph_binary, error_codes, remove_labels=
     if remove_cross_folder:
         getgraph_cmd.append('--remove-cross-folder')
 
-    if error_codes:
-        process = subprocess.Popen([getgraph_binary,
-                                    '--edgelist',
-                                    '--protobuf',
-                                    '--bitcode',
-                                    bitcode_path,
-                                    '--error-codes',
-                                    error_codes],
-                                   stdout=subprocess.PIPE)
-    else:
-        process = subprocess.Popen([getgraph_binary,
-                                    '--edgelist',
-                                    '--protobuf',
-                                    '--bitcode',
-                                    bitcode_path],
-                                   stdout=subprocess.PIPE)
-
-    out, err = process.communicate()
-    if err:
-        raise Exception("Unable to communicate with getgraph.")
+    process = subprocess.Popen(getgraph_cmd, stdout=subprocess.PIPE)
+    return StreamedEdgelist(process.stdout, process)
 
-    protobuf_edgelist = edgelist_pb2.Edgelist()
-    protobuf_edgelist.ParseFromString(out)
 
-    return protobuf_edgelist
+class StreamedEdgelist:
+    """
+    Reads the length-delimited EdgelistChunk stream written by getgraph --protobuf
+    (see EdgelistChunk in edgelist.proto). Looks like the old Edgelist
+    message to create_graph_from_edgelist: id_to_label maps ids to Edgelist.Label,
+    and edge yields objects with source, target, label, label_id and location.
+    edge can only be iterated once.
+    If process is given, its exit status is checked when the stream ends, so a
+    writer that dies between chunks is not mistaken for a short graph.
+    """
+    Edge = namedtuple('Edge', ['source', 'target', 'label', 'label_id', 'location'])
+    KIND_LABELS = ["", "call", "ret", "may_ret"]
+
+    def __init__(self, stream, process=None):
+        self.stream = stream
+        self.process = process
+        self.id_to_label = dict()
+        self.vertices = []
+        self.locations = []
+        # id_to_label is always in the first chunk
+        self.pending = self._read_chunk()
+        if self.pending is not None:
+            self._add_strings(self.pending)
+
+    def _read_chunk(self):
+        # Length prefix, one byte at a time
+        length = 0
+        shift = 0
+        while True:
+            b = self.stream.read(1)
+            if not b:
+                self._check_exit()
+                if shift:
+                    raise Exception("Truncated edgelist stream")
+                return None
+            b = bytearray(b)[0]
+            length |= (b & 0x7f) << shift
+            shift += 7
+            if not b & 0x80:
+                break
+        data = self.stream.read(length)
+        if len(data) != length:
+            self._check_exit()
+            raise Exception("Truncated edgelist stream")
+        chunk = edgelist_pb2.EdgelistChunk()
+        chunk.ParseFromString(data)
+        return chunk
+
+    def _check_exit(self):
+        if self.process is not None and self.process.wait() != 0:
+            raise Exception("getgraph exited with status %d" % self.process.returncode)
+
+    def _add_strings(self, chunk):
+        for key, value in chunk.id_to_label.items():
+            label = edgelist_pb2.Edgelist.Label()
+            label.CopyFrom(value)
+            self.id_to_label[key] = label
+        self.vertices.extend(chunk.vertex)
+        self.locations.extend(chunk.vertex_location)
+
+    @property
+    def edge(self):
+        chunk = self.pending
+        self.pending = None
+        while chunk is not None:
+            next_label = 0
+            for i in range(len(chunk.source)):
+                count = chunk.label_count[i]
+                source = chunk.source[i]
+                yield StreamedEdgelist.Edge(self.vertices[source],
+                                            self.vertices[chunk.target[i]],
+                                            StreamedEdgelist.KIND_LABELS[chunk.kind[i]],
+                                            list(chunk.label_id[next_label:next_label + count]),
+                                            self.locations[source])
+                next_label += count
+            chunk = self._read_chunk()
+            if chunk is not None:
+                self._add_strings(chunk)
 
 
 def create_graph_from_edgelist(protobuf_edgelist, remove_labels=None, interprocedural=True):
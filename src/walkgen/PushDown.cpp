@@ -0,0 +1,271 @@
+#include "PushDown.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+
+using namespace std;
+
+namespace {
+
+// Nested form used while building, flattened at the end
+struct BuildEdge {
+  vector<int> labels;
+  uint32_t push = PushDownGraph::NONE;
+};
+
+struct BuildNeighbor {
+  uint32_t target;
+  vector<BuildEdge> edges;
+};
+
+struct BuildVertex {
+  vector<BuildNeighbor> neighbors;
+  uint32_t return_node = PushDownGraph::NONE;
+  vector<uint32_t> may_ret;
+};
+
+struct BuildCall {
+  uint32_t vertex;
+  uint32_t neighbor;
+  uint32_t edge;
+};
+
+class PushDownBuilder {
+public:
+  explicit PushDownBuilder(size_t n) : vertices(n) {}
+
+  // Index of the neighbor v of u, added if needed
+  uint32_t neighbor(uint32_t u, uint32_t v) {
+    auto it = neighbor_index.insert(make_pair((uint64_t) u << 32 | v, vertices[u].neighbors.size()));
+    if (it.second) {
+      vertices[u].neighbors.push_back(BuildNeighbor{v, {}});
+    }
+    return it.first->second;
+  }
+
+  vector<BuildVertex> vertices;
+
+private:
+  unordered_map<uint64_t, uint32_t> neighbor_index;
+};
+
+}
+
+PushDownGraph::PushDownGraph(const CompactFlowGraph &G, const unordered_map<int, string> &all_labels,
+                             const vector<string> &remove_labels, bool interprocedural) {
+  for (const auto &kv : all_labels) {
+    bool add = true;
+    for (const string &r : remove_labels) {
+      if (kv.second.compare(0, r.size(), r) == 0) {
+        add = false;
+        break;
+      }
+    }
+    if (add) {
+      id_to_label.insert(kv);
+    }
+  }
+
+  PushDownBuilder builder(num_vertices(G));
+  vector<BuildVertex> &vertices = builder.vertices;
+  compact_vertex_t main_vtx = G.getVertex("main.0");
+
+  vector<BuildCall> call_edges;
+  BGL_FORALL_EDGES(e, G, CompactFlowGraph) {
+    compact_vertex_t u = source(e, G), v = target(e, G);
+    if (u == main_vtx || v == main_vtx) {
+      continue;
+    }
+
+    if (G[e].ret) {
+      vertices[u].return_node = v;
+    } else if (G[e].may_ret) {
+      vertices[u].may_ret.push_back(v);
+    } else if (G[e].call) {
+      uint32_t n = builder.neighbor(u, v);
+      call_edges.push_back(BuildCall{u, n, (uint32_t) vertices[u].neighbors[n].edges.size()});
+      vertices[u].neighbors[n].edges.push_back(BuildEdge());
+    } else {
+      BuildEdge edge;
+      for (int id : G[u].label_ids) {
+        if (id_to_label.count(id)) {
+          edge.labels.push_back(id);
+        }
+      }
+      vertices[u].neighbors[builder.neighbor(u, v)].edges.push_back(edge);
+    }
+  }
+
+  // Label each call with the callee through a parallel edge to the return node
+  int next_id = 0;
+  if (!id_to_label.empty()) {
+    for (const auto &kv : all_labels) {
+      next_id = max(next_id, kv.first + 1);
+    }
+  }
+  unordered_map<uint32_t, int> function_to_id;
+  for (const BuildCall &call : call_edges) {
+    uint32_t u = call.vertex;
+    uint32_t return_node = vertices[u].return_node;
+    if (return_node == NONE) {
+      cerr << "FATAL ERROR: Call site " << G[u].stack << " has no return node\n";
+      abort();
+    }
+
+    uint32_t callee = G.function_id(vertices[u].neighbors[call.neighbor].target);
+    auto it = function_to_id.find(callee);
+    if (it == function_to_id.end()) {
+      it = function_to_id.insert(make_pair(callee, next_id++)).first;
+      id_to_label[it->second] = G.function_name(callee);
+    }
+
+    BuildEdge ret;
+    ret.labels.push_back(it->second);
+    vertices[u].neighbors[builder.neighbor(u, return_node)].edges.push_back(ret);
+    if (interprocedural) {
+      vertices[u].neighbors[call.neighbor].edges[call.edge].push = return_node;
+    }
+  }
+
+  enter_fn_label = next_id++;
+  exit_fn_label = next_id++;
+  id_to_label[enter_fn_label] = "F2V_ENTERFN";
+  id_to_label[exit_fn_label] = "F2V_EXITFN";
+
+  // Flatten, moving the return node of every call site to the end of its neighbors
+  map<int, vector<Start>> starts;
+  neighbor_offsets.push_back(0);
+  edge_offsets.push_back(0);
+  label_offsets.push_back(0);
+  may_ret_offsets.push_back(0);
+  call_site.resize(vertices.size(), 0);
+  for (uint32_t u = 0; u < vertices.size(); ++u) {
+    BuildVertex &vertex = vertices[u];
+    auto ret = find_if(vertex.neighbors.begin(), vertex.neighbors.end(),
+                       [&](const BuildNeighbor &n) { return n.target == vertex.return_node; });
+    if (ret != vertex.neighbors.end()) {
+      rotate(ret, ret + 1, vertex.neighbors.end());
+      call_site[u] = 1;
+    }
+
+    for (const BuildNeighbor &neighbor : vertex.neighbors) {
+      neighbor_target.push_back(neighbor.target);
+      for (const BuildEdge &edge : neighbor.edges) {
+        for (int id : edge.labels) {
+          starts[id].push_back(Start{neighbor.target, (uint32_t) edge_push.size()});
+        }
+        edge_push.push_back(edge.push);
+        labels.insert(labels.end(), edge.labels.begin(), edge.labels.end());
+        label_offsets.push_back(labels.size());
+      }
+      edge_offsets.push_back(edge_push.size());
+    }
+    neighbor_offsets.push_back(neighbor_target.size());
+
+    may_ret_targets.insert(may_ret_targets.end(), vertex.may_ret.begin(), vertex.may_ret.end());
+    may_ret_offsets.push_back(may_ret_targets.size());
+
+    // Free as we go, the nested form is several times larger
+    BuildVertex().neighbors.swap(vertex.neighbors);
+    vector<uint32_t>().swap(vertex.may_ret);
+  }
+  label_to_starts.assign(starts.begin(), starts.end());
+}
+
+PushDownWalker::PushDownWalker(const PushDownGraph &G, bool enterexit, bool interprocedural,
+                               double bias_constant) :
+    G(G), enterexit(enterexit), interprocedural(interprocedural), bias_constant(bias_constant) {
+
+  if (bias_constant == 0.0) {
+    cerr << "FATAL ERROR: bias_constant must not be 0\n";
+    abort();
+  }
+}
+
+unsigned PushDownWalker::randomWalk(unsigned path_length, size_t label_index, uint64_t seed,
+                                    vector<int> &walk) {
+  rng.seed(seed);
+  const vector<PushDownGraph::Start> &starts = G.label_to_starts[label_index].second;
+  const PushDownGraph::Start &start = starts[rng.index(starts.size())];
+
+  stack.clear();
+  calls = 0;
+  max_stack_distance = 0;
+
+  walk.insert(walk.end(), G.labels.begin() + G.label_offsets[start.edge],
+              G.labels.begin() + G.label_offsets[start.edge + 1]);
+  uint32_t next_node = start.target;
+  unsigned edges_visited = 1;
+  while (edges_visited < path_length) {
+    next_node = randomTransition(next_node, walk);
+    if (next_node == PushDownGraph::NONE) {
+      break;
+    }
+    ++edges_visited;
+  }
+  return edges_visited;
+}
+
+uint32_t PushDownWalker::randomTransition(uint32_t node, vector<int> &walk) {
+  uint32_t first = G.neighbor_offsets[node], last = G.neighbor_offsets[node + 1];
+
+  // Alter probability of following call edges for biased walk.
+  // The return node is the last neighbor of a call site.
+  if (G.call_site[node]) {
+    while ((size_t) calls >= prob_enter_call.size()) {
+      prob_enter_call.push_back(min(0.5, 1.0 / pow(bias_constant, prob_enter_call.size())));
+    }
+    if (rng.real() < prob_enter_call[calls]) {
+      --last;
+    } else {
+      first = last - 1;
+    }
+  }
+
+  // Pop
+  if (first == last) {
+    if (enterexit) {
+      walk.push_back(G.exit_fn_label);
+    }
+    if (!interprocedural) {
+      return PushDownGraph::NONE;
+    }
+    if (stack.empty()) {
+      // Randomly select a return site of a function that could be our caller.
+      // Without may_ret edges this is the main function and we must stop.
+      uint32_t ret_first = G.may_ret_offsets[node], ret_last = G.may_ret_offsets[node + 1];
+      if (ret_first == ret_last) {
+        return PushDownGraph::NONE;
+      }
+      return G.may_ret_targets[ret_first + rng.index(ret_last - ret_first)];
+    }
+    --calls;
+    uint32_t top = stack.back();
+    stack.pop_back();
+    return top;
+  }
+
+  // There can be multiple edges (u, v) with different labels.
+  // Randomly select one of those edges to pull the label from.
+  uint32_t n = first + rng.index(last - first);
+  uint32_t e = G.edge_offsets[n] + rng.index(G.edge_offsets[n + 1] - G.edge_offsets[n]);
+  walk.insert(walk.end(), G.labels.begin() + G.label_offsets[e], G.labels.begin() + G.label_offsets[e + 1]);
+
+  // Internal
+  uint32_t push = G.edge_push[e];
+  if (push == PushDownGraph::NONE) {
+    return G.neighbor_target[n];
+  }
+
+  // Call
+  if (enterexit) {
+    walk.push_back(G.enter_fn_label);
+  }
+  stack.push_back(push);
+  ++calls;
+  if ((unsigned) calls > max_stack_distance) {
+    max_stack_distance = calls;
+  }
+  return G.neighbor_target[n];
+}
@@ -0,0 +1,143 @@
+// Native version of walker/pushdown.py.
+//
+// PushDownGraph applies the same transformation as create_graph_from_edgelist
+// to the ICFG, and PushDownWalker implements PushDown.random_walk on it:
+//   - main.0 and its edges are dropped
+//   - ret edges become the return node of the call site
+//   - may_ret edges become the possible return sites of an exit node
+//   - every call edge gets a parallel edge to the return node labeled with the
+//     name of the callee, and pushes the return node when interprocedural
+//   - other edges carry the labels of their source vertex
+// Label ids above the largest id from the labels pass are the callee names and
+// the F2V_ENTERFN / F2V_EXITFN tokens.
+
+#ifndef PUSHDOWN_HPP
+#define PUSHDOWN_HPP
+
+#include "CompactFlowGraph.hpp"
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Every choice the walker makes is uniform, so the graph is stored as flat
+// offset arrays and each step is a couple of index computations.
+class PushDownGraph {
+public:
+  static const uint32_t NONE = UINT32_MAX;
+
+  // Where a walk can start for a label: the target of a labeled edge
+  struct Start {
+    uint32_t target;
+    uint32_t edge;
+  };
+
+  // Labels starting with any of remove_labels are dropped from internal edges
+  PushDownGraph(const CompactFlowGraph &G, const std::unordered_map<int, std::string> &id_to_label,
+                const std::vector<std::string> &remove_labels, bool interprocedural);
+
+  uint32_t numVertices() const {
+    return neighbor_offsets.size() - 1;
+  }
+
+  // Distinct targets of v are [neighbor_offsets[v], neighbor_offsets[v + 1]).
+  // At a call site the return node is the last of them.
+  std::vector<uint32_t> neighbor_offsets;
+  std::vector<uint8_t> call_site;
+  std::vector<uint32_t> neighbor_target;
+
+  // Parallel edges to neighbor n are [edge_offsets[n], edge_offsets[n + 1])
+  std::vector<uint32_t> edge_offsets;
+  std::vector<uint32_t> edge_push;
+
+  // Labels of edge e are [label_offsets[e], label_offsets[e + 1])
+  std::vector<uint32_t> label_offsets;
+  std::vector<int> labels;
+
+  // Possible return sites of exit node v are [may_ret_offsets[v], may_ret_offsets[v + 1])
+  std::vector<uint32_t> may_ret_offsets;
+  std::vector<uint32_t> may_ret_targets;
+
+  // Sorted by label id
+  std::vector<std::pair<int, std::vector<Start>>> label_to_starts;
+
+  std::unordered_map<int, std::string> id_to_label;
+  int enter_fn_label;
+  int exit_fn_label;
+};
+
+// SplitMix64, used to derive independent seeds from one user seed
+inline uint64_t mix_seed(uint64_t seed, uint64_t stream) {
+  uint64_t z = seed + 0x9e3779b97f4a7c15ull * (stream + 1);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+// SplitMix64 generator. Every walk gets its own stream, and seeding this is a
+// single store where mt19937_64 fills 312 words.
+class WalkRng {
+public:
+  typedef uint64_t result_type;
+
+  explicit WalkRng(uint64_t seed = 0) : state(seed) {}
+
+  void seed(uint64_t s) {
+    state = s;
+  }
+
+  uint64_t operator()() {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+  }
+
+  static constexpr uint64_t min() { return 0; }
+  static constexpr uint64_t max() { return UINT64_MAX; }
+
+  // Uniform in [0, n)
+  size_t index(size_t n) {
+    return (size_t) (((unsigned __int128) (*this)() * n) >> 64);
+  }
+
+  // Uniform in [0, 1)
+  double real() {
+    return ((*this)() >> 11) * (1.0 / 9007199254740992.0);
+  }
+
+private:
+  uint64_t state;
+};
+
+// Not thread safe, but any number of walkers can share a PushDownGraph
+class PushDownWalker {
+public:
+  PushDownWalker(const PushDownGraph &G, bool enterexit, bool interprocedural, double bias_constant);
+
+  // Perform a single random walk from a random edge with the label at
+  // label_to_starts[label_index], drawing from a stream seeded with seed.
+  // Appends the labels to walk and returns the number of edges visited.
+  unsigned randomWalk(unsigned path_length, size_t label_index, uint64_t seed, std::vector<int> &walk);
+
+  // Largest stack distance reached by the last walk
+  unsigned max_stack_distance = 0;
+
+private:
+  const PushDownGraph &G;
+  WalkRng rng;
+  bool enterexit;
+  bool interprocedural;
+  double bias_constant;
+
+  std::vector<uint32_t> stack;
+  int calls = 0;
+
+  // min(0.5, 1 / bias_constant ** calls), grown on demand
+  std::vector<double> prob_enter_call;
+
+  uint32_t randomTransition(uint32_t node, std::vector<int> &walk);
+};
+
+#endif
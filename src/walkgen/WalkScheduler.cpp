@@ -0,0 +1,210 @@
+#include "WalkScheduler.hpp"
+#include "Parallel.hpp"
+#include "Corpus.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+
+using namespace std;
+
+namespace {
+
+// Tasks per block. Large enough that the deques are rarely touched, small
+// enough that the last blocks of a run balance out.
+const size_t WALK_BLOCK_SIZE = 256;
+
+// Per-thread output beyond this goes to a temporary file until the merge
+const size_t WALK_SPILL_BYTES = 64 << 20;
+
+struct WalkBlock {
+  uint32_t round;
+  uint32_t first;
+  uint32_t last;
+
+  // Where the output of the block went
+  unsigned thread = 0;
+  uint64_t offset = 0;
+  uint64_t length = 0;
+};
+
+// Output of one thread. Offsets count from the start of everything written,
+// including what has been spilled.
+class WalkBuffer {
+public:
+  ~WalkBuffer() {
+    if (spill) {
+      fclose(spill);
+    }
+  }
+
+  uint64_t size() const {
+    return spilled + buf.size();
+  }
+
+  void maybeSpill() {
+    if (buf.size() < WALK_SPILL_BYTES) {
+      return;
+    }
+    if (!spill) {
+      spill = tmpfile();
+    }
+    if (!spill || fwrite(buf.data(), 1, buf.size(), spill) != buf.size() || fflush(spill) != 0) {
+      cerr << "FATAL ERROR: Unable to spill walks to a temporary file\n";
+      abort();
+    }
+    spilled += buf.size();
+    buf.clear();
+  }
+
+  void copy(uint64_t offset, uint64_t length, ostream &out) const {
+    vector<char> chunk;
+    while (length > 0 && offset < spilled) {
+      size_t n = min<uint64_t>(min<uint64_t>(length, spilled - offset), WALK_SPILL_BYTES);
+      chunk.resize(n);
+      if (pread(fileno(spill), chunk.data(), n, offset) != (ssize_t) n) {
+        cerr << "FATAL ERROR: Unable to read spilled walks\n";
+        abort();
+      }
+      out.write(chunk.data(), n);
+      offset += n;
+      length -= n;
+    }
+    if (length > 0) {
+      out.write(buf.data() + (offset - spilled), length);
+    }
+  }
+
+  std::string buf;
+
+private:
+  FILE *spill = nullptr;
+  uint64_t spilled = 0;
+};
+
+struct WorkDeque {
+  std::mutex m;
+  std::deque<size_t> blocks;
+};
+
+// Own blocks come off the back, stolen ones off the front of the victim
+bool next_block(vector<WorkDeque> &queues, unsigned t, size_t &block) {
+  for (unsigned k = 0; k < queues.size(); ++k) {
+    WorkDeque &q = queues[(t + k) % queues.size()];
+    lock_guard<mutex> lock(q.m);
+    if (q.blocks.empty()) {
+      continue;
+    }
+    if (k == 0) {
+      block = q.blocks.back();
+      q.blocks.pop_back();
+    } else {
+      block = q.blocks.front();
+      q.blocks.pop_front();
+    }
+    return true;
+  }
+  return false;
+}
+
+}
+
+void walk_all_labels(const PushDownGraph &G, const WalkOptions &options, unsigned threads,
+                     ostream &out, vector<unsigned> *distances) {
+  size_t num_labels = G.label_to_starts.size();
+  unsigned rounds = options.walks_per_label;
+  if (num_labels == 0 || rounds == 0) {
+    return;
+  }
+
+  // Label order of every round, shuffled from its own stream
+  vector<vector<uint32_t>> orders(rounds);
+  ep::parallel_for(rounds, threads, [&](size_t round) {
+    vector<uint32_t> &order = orders[round];
+    order.resize(num_labels);
+    for (size_t i = 0; i < num_labels; ++i) {
+      order[i] = i;
+    }
+    WalkRng rng(mix_seed(options.seed, round));
+    for (size_t i = num_labels; i > 1; --i) {
+      swap(order[i - 1], order[rng.index(i)]);
+    }
+  });
+
+  vector<WalkBlock> blocks;
+  for (uint32_t round = 0; round < rounds; ++round) {
+    for (size_t first = 0; first < num_labels; first += WALK_BLOCK_SIZE) {
+      WalkBlock block;
+      block.round = round;
+      block.first = first;
+      block.last = min(num_labels, first + WALK_BLOCK_SIZE);
+      blocks.push_back(block);
+    }
+  }
+
+  threads = max(1u, (unsigned) min<size_t>(threads, blocks.size()));
+  vector<WorkDeque> queues(threads);
+  for (size_t b = 0; b < blocks.size(); ++b) {
+    queues[b * threads / blocks.size()].blocks.push_back(b);
+  }
+  if (distances) {
+    distances->assign((size_t) rounds * num_labels, 0);
+  }
+
+  vector<WalkBuffer> buffers(threads);
+  auto worker = [&](unsigned t) {
+    PushDownWalker walker(G, options.enterexit, options.interprocedural, options.bias_constant);
+    WalkBuffer &buffer = buffers[t];
+    vector<int> walk;
+    vector<uint32_t> sentence;
+    size_t b;
+    while (next_block(queues, t, b)) {
+      WalkBlock &block = blocks[b];
+      block.thread = t;
+      block.offset = buffer.size();
+      uint64_t round_seed = mix_seed(options.seed, block.round);
+      for (uint32_t pos = block.first; pos < block.last; ++pos) {
+        uint32_t label = orders[block.round][pos];
+        walk.clear();
+        walker.randomWalk(options.path_length, label,
+                          mix_seed(round_seed, (uint64_t) G.label_to_starts[label].first), walk);
+        if (distances) {
+          (*distances)[(size_t) block.round * num_labels + pos] = walker.max_stack_distance;
+        }
+        if (walk.size() > 1 && options.corpus_ids) {
+          sentence.clear();
+          for (const int id : walk) {
+            sentence.push_back((*options.corpus_ids)[id]);
+          }
+          ep::append_sentence(buffer.buf, sentence.data(), sentence.size());
+        } else if (walk.size() > 1) {
+          for (size_t j = 0; j < walk.size(); ++j) {
+            if (j) {
+              buffer.buf += ' ';
+            }
+            buffer.buf += G.id_to_label.at(walk[j]);
+          }
+          buffer.buf += '\n';
+        }
+      }
+      block.length = buffer.size() - block.offset;
+      buffer.maybeSpill();
+    }
+  };
+
+  vector<thread> pool;
+  for (unsigned t = 1; t < threads; ++t) {
+    pool.emplace_back(worker, t);
+  }
+  worker(0);
+  for (thread &t : pool) {
+    t.join();
+  }
+
+  for (const WalkBlock &block : blocks) {
+    buffers[block.thread].copy(block.offset, block.length, out);
+  }
+}
@@ -0,0 +1,36 @@
+// Parallel random_walk_all_labels.
+//
+// Every (round, label) pair is one task, and each task draws from its own
+// stream derived from the seed, the round and the label id. Within a round
+// labels are visited in an order shuffled from the seed and the round. Tasks
+// are grouped into blocks that are handed out through per-thread deques, with
+// idle threads stealing from the others. Each thread writes to its own buffer,
+// and the buffers are merged in task order at the end, so the output does not
+// depend on the number of threads.
+
+#ifndef WALKSCHEDULER_HPP
+#define WALKSCHEDULER_HPP
+
+#include "PushDown.hpp"
+#include <ostream>
+#include <vector>
+
+struct WalkOptions {
+  unsigned path_length = 200;
+  unsigned walks_per_label = 100;
+  bool enterexit = false;
+  bool interprocedural = true;
+  double bias_constant = 1.0;
+  uint64_t seed = 0;
+  // Corpus token id of every walk label id. If set, walks are written as binary
+  // corpus sentences (see Corpus.hpp) instead of text.
+  const std::vector<uint32_t> *corpus_ids = nullptr;
+};
+
+// Writes every walk with more than one label to out, one per line or sentence.
+// If distances is set it receives the largest stack distance of every walk, in
+// the same order.
+void walk_all_labels(const PushDownGraph &G, const WalkOptions &options, unsigned threads,
+                     std::ostream &out, std::vector<unsigned> *distances = nullptr);
+
+#endif
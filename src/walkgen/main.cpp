@@ -0,0 +1,131 @@
+#include "PushDown.hpp"
+#include "WalkScheduler.hpp"
+#include "Llvm.hpp"
+#include "Parallel.hpp"
+#include "Corpus.hpp"
+#include <boost/program_options.hpp>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+
+using namespace std;
+
+// Native replacement for "python -m walker walk". Reads the ICFG directly
+// instead of going through getgraph and networkx.
+int main(int argc, char **argv) {
+  namespace po = boost::program_options;
+  po::options_description desc("Options");
+  desc.add_options()
+      ("help", "produce help message")
+      ("bitcode", po::value<string>()->required(), "Path to bitcode file")
+      ("output", po::value<string>(), "Write walks to this file instead of stdout")
+      ("corpus", po::bool_switch(), "Write walks as a binary corpus, and its vocabulary to <output>.vocab. Requires --output")
+      ("length", po::value<unsigned>()->default_value(200), "Maximum path length")
+      ("walks", po::value<unsigned>()->default_value(100), "Number of walks per label")
+      ("remove", po::value<vector<string>>()->multitoken(), "Labels to remove (prefixes)")
+      ("interprocedural", po::value<unsigned>()->default_value(1), "Context sensitive walk (0 or 1)")
+      ("enterexit", po::bool_switch(), "Function enter exit labels during walk")
+      ("bias", po::value<double>()->default_value(1.0), "Bias constant (1.0 is unbiased)")
+      ("distances", po::value<string>(), "Write stack distances to this file")
+      ("seed", po::value<uint64_t>()->default_value(0), "Random seed. Output does not depend on --threads")
+      ("threads", po::value<unsigned>()->default_value(1), "Worker threads (0 = all cores)")
+      ("remove-cross-folder", po::bool_switch(), "Remove cross-folder call edges coming from points-to analysis.")
+      ("cache-dir", po::value<string>(), "Directory for cached ICFGs, reused while the inputs are unchanged")
+      ("error-codes", po::value<string>(), "Path to error codes file");
+  po::variables_map vm;
+  try {
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+  } catch (po::error &e) {
+    cerr << "ERROR: " << e.what() << endl << endl;
+    cerr << desc << endl;
+    return 1;
+  }
+
+  if (vm.count("help")) {
+    cerr << desc << endl;
+    return 0;
+  }
+
+  string error_codes, cache_dir;
+  if (vm.count("error-codes")) {
+    error_codes = vm["error-codes"].as<string>();
+  }
+  if (vm.count("cache-dir")) {
+    cache_dir = vm["cache-dir"].as<string>();
+  }
+  vector<string> remove;
+  if (vm.count("remove")) {
+    remove = vm["remove"].as<vector<string>>();
+  }
+  WalkOptions options;
+  options.interprocedural = vm["interprocedural"].as<unsigned>() != 0;
+  options.enterexit = vm["enterexit"].as<bool>();
+  options.bias_constant = vm["bias"].as<double>();
+  options.path_length = vm["length"].as<unsigned>();
+  options.walks_per_label = vm["walks"].as<unsigned>();
+  options.seed = vm["seed"].as<uint64_t>();
+  bool corpus = vm["corpus"].as<bool>();
+  if (corpus && !vm.count("output")) {
+    cerr << "ERROR: --corpus requires --output" << endl;
+    return 1;
+  }
+  unsigned threads = ep::resolve_threads(vm["threads"].as<unsigned>());
+
+  p2v::Llvm passes(vm["bitcode"].as<string>(), error_codes, vm["remove-cross-folder"].as<bool>(),
+                   threads, cache_dir);
+  PushDownGraph G(*passes.getCompactFlowGraph(), passes.id_to_label, remove,
+                  options.interprocedural);
+
+  // Walk label ids are only meaningful to G, so give each one its corpus id
+  unique_ptr<ep::CorpusVocabulary> vocab;
+  vector<uint32_t> corpus_ids;
+  if (corpus) {
+    const CompactFlowGraph &CG = *passes.getCompactFlowGraph();
+    vector<string> function_names;
+    for (uint32_t fn = 0; fn < CG.num_functions(); ++fn) {
+      function_names.push_back(CG.function_name(fn));
+    }
+    vocab.reset(new ep::CorpusVocabulary(passes.id_to_label, function_names));
+    map<int, string> labels(G.id_to_label.begin(), G.id_to_label.end());
+    corpus_ids.assign(labels.empty() ? 0 : labels.rbegin()->first + 1, 0);
+    for (const auto &kv : labels) {
+      corpus_ids[kv.first] = vocab->intern(kv.second);
+    }
+    options.corpus_ids = &corpus_ids;
+  }
+
+  ofstream output_file;
+  if (vm.count("output")) {
+    output_file.open(vm["output"].as<string>(), ios::binary);
+    if (!output_file) {
+      cerr << "FATAL ERROR: Unable to open " << vm["output"].as<string>() << endl;
+      abort();
+    }
+  }
+  ostream &out = vm.count("output") ? output_file : cout;
+
+  if (corpus) {
+    out.write(ep::CORPUS_MAGIC, sizeof(ep::CORPUS_MAGIC));
+  }
+
+  vector<unsigned> distances;
+  walk_all_labels(G, options, threads, out, vm.count("distances") ? &distances : nullptr);
+  out.flush();
+
+  if (corpus && !vocab->write(vm["output"].as<string>() + ".vocab")) {
+    cerr << "FATAL ERROR: Unable to write " << vm["output"].as<string>() << ".vocab" << endl;
+    abort();
+  }
+
+  if (vm.count("distances")) {
+    ofstream distances_file(vm["distances"].as<string>());
+    for (size_t i = 0; i < distances.size(); ++i) {
+      distances_file << (i ? "," : "") << distances[i];
+    }
+    distances_file << "\r\n";
+  }
+
+  return 0;
+}
@@ -1,5 +1,22 @@
 #include "test.hpp"
 #include "Context.hpp"
+#include "Llvm.hpp"
+#include "GraphCache.hpp"
+#include "PushDown.hpp"
+#include "WalkScheduler.hpp"
+#include "GzipStream.hpp"
+#include "Corpus.hpp"
+#include "PostDomCache.hpp"
+#include "PreActionSearch.hpp"
+#include "SetBasedDFS.hpp"
+#include "FlatMap.hpp"
+#include "HandlersPass.hpp"
+#include "BranchSafety.hpp"
+#include "llvm/IRReader/IRReader.h"
+#include "llvm/Support/SourceMgr.h"
+#include <fstream>
+#include <random>
+#include <unistd.h>
 
 using namespace std;
 
@@ -40,6 +57,20 @@ string run_k_context(string source_name, unsigned path_length,
   return ss.str();                        
 }
 
+// Runs that each build their own graph can find the same paths in a different
+// order, since vertex and edge sets are ordered by address, so their outputs are
+// compared by sorted lines
+vector<string> sorted_lines(const string &text) {
+  stringstream ss(text);
+  vector<string> lines;
+  string line;
+  while (getline(ss, line)) {
+    lines.push_back(line);
+  }
+  sort(lines.begin(), lines.end());
+  return lines;
+}
+
 TEST_F(FullProgramTest, Trivial) {
   string res = run_k_context("trivial", 100);
   string expected = "PATH_BEGIN interesting PATH_END\n";
@@ -177,3 +208,673 @@ TEST_F(FullProgramTest, ErrEarlyStr) {
   ASSERT_NE(res.find("PATH_BEGIN interesting foo2 RETURN_NO_ERR PATH_END\n"), string::npos) << res;
   ASSERT_EQ(std::count(res.begin(), res.end(), '\n'), 1) << res;
 }
+
+// Every call site gets its own search, so sharding them over threads must not
+// change the paths
+TEST_F(FullProgramTest, ParallelPathsMatch) {
+  auto paths = [](unsigned threads) {
+    stringstream ss;
+    run_k_context_on_file("errpath_multi.bc", INTERESTING_TXT, ss, 100, true, true,
+                          "DEFAULT", "../../config/codes.txt", "", threads);
+    return sorted_lines(ss.str());
+  };
+
+  vector<string> sequential = paths(1);
+  ASSERT_FALSE(sequential.empty());
+  ASSERT_THAT(paths(4), ContainerEq(sequential));
+}
+
+// The frozen graph must have exactly the vertices and edges of the FlowGraph
+TEST_F(FullProgramTest, CompactFlowGraphMatches) {
+  p2v::Llvm passes("original.bc");
+  shared_ptr<FlowGraph> FG = passes.getFlowGraph();
+  shared_ptr<const CompactFlowGraph> CFG = passes.getCompactFlowGraph();
+  ASSERT_TRUE(FG);
+  ASSERT_TRUE(CFG);
+
+  ASSERT_EQ(num_vertices(*CFG), boost::num_vertices(FG->G));
+  ASSERT_EQ(num_edges(*CFG), boost::num_edges(FG->G));
+  ASSERT_EQ((*CFG)[CFG->get_entry()].stack, "main.0");
+
+  BGL_FORALL_VERTICES(v, FG->G, _FlowGraph) {
+    const FlowVertex &fv = FG->G[v];
+    compact_vertex_t cv = CFG->getVertex(fv.stack);
+    ASSERT_NE(cv, CompactFlowGraph::null_vertex()) << fv.stack;
+    ASSERT_EQ(cv, fv.index);
+    ASSERT_EQ((*CFG)[cv].I, fv.I);
+    ASSERT_EQ((*CFG)[cv].loc, fv.loc);
+    ASSERT_EQ(out_degree(cv, *CFG), boost::out_degree(v, FG->G)) << fv.stack;
+    ASSERT_EQ(in_degree(cv, *CFG), boost::in_degree(v, FG->G)) << fv.stack;
+  }
+
+  BGL_FORALL_EDGES(e, FG->G, _FlowGraph) {
+    compact_vertex_t s = FG->G[boost::source(e, FG->G)].index;
+    compact_vertex_t t = FG->G[boost::target(e, FG->G)].index;
+    bool found = false;
+    BGL_FORALL_OUTEDGES(s, ce, *CFG, CompactFlowGraph) {
+      if (target(ce, *CFG) == t) {
+        ASSERT_EQ((*CFG)[ce].call, FG->G[e].call);
+        ASSERT_EQ((*CFG)[ce].ret, FG->G[e].ret);
+        ASSERT_EQ((*CFG)[ce].may_ret, FG->G[e].may_ret);
+        found = true;
+      }
+    }
+    ASSERT_TRUE(found) << FG->G[boost::source(e, FG->G)].stack;
+  }
+}
+
+// Interned stack keys and their textual form must name the same vertex
+TEST_F(FullProgramTest, StackKeysRoundTrip) {
+  p2v::Llvm passes("original.bc");
+  shared_ptr<FlowGraph> FG = passes.getFlowGraph();
+  ASSERT_TRUE(FG);
+
+  BGL_FORALL_VERTICES(v, FG->G, _FlowGraph) {
+    const FlowVertex &fv = FG->G[v];
+    ASSERT_NE(fv.key, 0u) << fv.stack;
+    ASSERT_EQ(FG->getStackNames().str(fv.key), fv.stack);
+    ASSERT_EQ(FG->getStackNames().lookup(fv.stack), fv.key) << fv.stack;
+  }
+  ASSERT_TRUE(FG->getVertex("main.0"));
+}
+
+// Building the ICFG on several threads must give exactly the sequential graph
+TEST_F(FullProgramTest, ParallelFlowGraphMatches) {
+  p2v::Llvm sequential("errpath_motivating.bc", "", false, 1);
+  p2v::Llvm parallel("errpath_motivating.bc", "", false, 4);
+
+  stringstream expected, actual;
+  sequential.getCompactFlowGraph()->write_graphviz(expected);
+  parallel.getCompactFlowGraph()->write_graphviz(actual);
+  ASSERT_EQ(actual.str(), expected.str());
+}
+
+// releaseFlowGraph must hand over the graph the pass built, not a copy.
+// A copy kept stack_vertex_map pointing into the pass's graph and doubled peak memory.
+TEST_F(FullProgramTest, FlowGraphHandoffDoesNotCopy) {
+  llvm::SMDiagnostic Err;
+  unique_ptr<llvm::Module> Mod(llvm::parseIRFile("errpath_motivating.bc", Err, llvm::getGlobalContext()));
+  ASSERT_TRUE(Mod);
+  llvm::Function *main = Mod->getFunction("main");
+  ASSERT_TRUE(main);
+
+  llvm::legacy::PassManager PM;
+  ControlFlowPass *cfp = new ControlFlowPass();
+  PM.add(new NamesPass());
+  PM.add(cfp);
+  PM.run(*Mod);
+
+  FlowGraph *built = cfp->FG.get();
+  ASSERT_TRUE(built);
+  flow_vertex_t entry = cfp->getFunctionVertex(main);
+
+  unique_ptr<FlowGraph> released = cfp->releaseFlowGraph();
+  ASSERT_FALSE(cfp->FG);
+  // A copy would live at a new address, with new vertex descriptors
+  ASSERT_EQ(built, released.get());
+  bool owned = false;
+  BGL_FORALL_VERTICES(v, released->G, _FlowGraph) {
+    if (v == entry) owned = true;
+  }
+  ASSERT_TRUE(owned);
+  ASSERT_EQ(entry, released->getVertex(released->G[entry].stack));
+}
+
+// A field of /proc/self/status in kB, such as "VmRSS:" or "VmHWM:" (peak RSS)
+static long status_kb(const string &field) {
+  ifstream status("/proc/self/status");
+  string line;
+  while (getline(status, line)) {
+    if (line.compare(0, field.size(), field) == 0) {
+      return stol(line.substr(field.size()));
+    }
+  }
+  return -1;
+}
+
+// Only does something in the fresh process started by measure_peak_rss, where
+// the peak RSS is not left over from earlier tests. Prints how far the peak
+// rose above the RSS at the start, in kB.
+TEST_F(FullProgramTest, PeakRssChild) {
+  const char *mode = getenv("F2V_PEAK_RSS");
+  if (!mode) return;
+  long before = status_kb("VmRSS:");
+
+  if (string(mode) == "llvm") {
+    p2v::Llvm passes("large.bc");
+    cout << "PEAK_RSS " << status_kb("VmHWM:") - before << endl;
+    return;
+  }
+
+  // The passes p2v::Llvm runs, with the graph left in the pass
+  llvm::SMDiagnostic Err;
+  unique_ptr<llvm::Module> Mod(llvm::parseIRFile("large.bc", Err, llvm::getGlobalContext()));
+  ASSERT_TRUE(Mod);
+  llvm::legacy::PassManager PM;
+  ControlFlowPass *cfp = new ControlFlowPass();
+  PM.add(new NamesPass());
+  PM.add(cfp);
+  PM.add(new InstructionLabelsPass());
+  PM.run(*Mod);
+  long built = status_kb("VmHWM:") - before;
+
+  // Lower bound on the heap a copy takes: the bundled properties alone,
+  // without the per-vertex and per-edge set nodes
+  const _FlowGraph &G = cfp->FG->G;
+  size_t graph_bytes = num_vertices(G) * sizeof(FlowVertex) + num_edges(G) * sizeof(FlowEdge);
+  FlowGraph copy(*cfp->FG);
+  long copied = status_kb("VmHWM:") - before;
+  cout << "PEAK_RSS " << built << " " << copied << " " << graph_bytes / 1024 << endl;
+}
+
+// Runs PeakRssChild in mode in a new process of this binary, and returns the
+// numbers it printed
+static vector<long> measure_peak_rss(const string &mode) {
+  char exe[4096];
+  ssize_t n = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+  if (n < 0) return vector<long>();
+  exe[n] = 0;
+
+  string command = "F2V_PEAK_RSS=" + mode + " " + exe + " --gtest_filter=FullProgramTest.PeakRssChild";
+  FILE *out = popen(command.c_str(), "r");
+  if (!out) return vector<long>();
+  vector<long> ret;
+  char line[4096];
+  while (fgets(line, sizeof(line), out)) {
+    istringstream ss(line);
+    string tag;
+    ss >> tag;
+    long value;
+    while (tag == "PEAK_RSS" && ss >> value) {
+      ret.push_back(value);
+    }
+  }
+  pclose(out);
+  return ret;
+}
+
+// Building a p2v::Llvm must not raise peak memory a graph's worth above the
+// passes that build the graph. The old deep copy kept both graphs alive until
+// the PassManager went away. Both are measured on large.bc in a fresh process,
+// and the same measurement of an explicit copy shows a copy would be caught.
+TEST_F(FullProgramTest, FlowGraphHandoffPeakRss) {
+  vector<long> passes = measure_peak_rss("passes");
+  vector<long> llvm = measure_peak_rss("llvm");
+  ASSERT_EQ(passes.size(), 3u);
+  ASSERT_EQ(llvm.size(), 1u);
+  long built = passes[0], copied = passes[1], graph_kb = passes[2];
+
+  ASSERT_GT(graph_kb, 1024);
+  ASSERT_GE(copied - built, graph_kb / 2);
+  ASSERT_LT(llvm[0], built + graph_kb / 2);
+}
+
+// A graph read back from the cache must match the one built by the passes
+TEST_F(FullProgramTest, GraphCacheRoundTrip) {
+  char cache_dir[] = "/tmp/f2v-cache-XXXXXX";
+  ASSERT_TRUE(mkdtemp(cache_dir));
+
+  p2v::Llvm uncached("errpath_motivating.bc");
+  p2v::Llvm first("errpath_motivating.bc", "", false, 1, cache_dir);
+  p2v::Llvm second("errpath_motivating.bc", "", false, 1, cache_dir);
+  ASSERT_FALSE(first.loaded_from_cache);
+  ASSERT_TRUE(second.loaded_from_cache);
+
+  stringstream expected, actual;
+  uncached.getCompactFlowGraph()->write_graphviz(expected);
+  second.getCompactFlowGraph()->write_graphviz(actual);
+  ASSERT_EQ(actual.str(), expected.str());
+  ASSERT_THAT(second.id_to_label, ContainerEq(uncached.id_to_label));
+  ASSERT_THAT(second.getBootstrapFns(), ContainerEq(uncached.getBootstrapFns()));
+
+  shared_ptr<FlowGraph> FG = second.getFlowGraph();
+  BGL_FORALL_VERTICES(v, uncached.getFlowGraph()->G, _FlowGraph) {
+    const FlowVertex &fv = uncached.getFlowGraph()->G[v];
+    flow_vertex_t cached = FG->getVertex(fv.stack);
+    ASSERT_TRUE(cached);
+    ASSERT_EQ(FG->G[cached].index, fv.index);
+    ASSERT_EQ(FG->G[cached].loc.file, fv.loc.file);
+    ASSERT_EQ(FG->G[cached].loc.line, fv.loc.line);
+    ASSERT_THAT(FG->G[cached].label_ids, ContainerEq(fv.label_ids));
+  }
+
+  string cache_path = p2v::graph_cache_path(cache_dir, "errpath_motivating.bc", "", false);
+  remove(cache_path.c_str());
+  rmdir(cache_dir);
+}
+
+// Walks depend only on the seed, not on the number of threads
+TEST_F(FullProgramTest, PushDownWalksReproducible) {
+  p2v::Llvm passes("errpath_motivating.bc");
+  PushDownGraph G(*passes.getCompactFlowGraph(), passes.id_to_label, {}, true);
+  ASSERT_FALSE(G.label_to_starts.empty());
+
+  WalkOptions options;
+  options.path_length = 50;
+  options.walks_per_label = 20;
+  options.enterexit = true;
+  options.seed = 7;
+
+  stringstream sequential, parallel;
+  vector<unsigned> sequential_distances, parallel_distances;
+  walk_all_labels(G, options, 1, sequential, &sequential_distances);
+  walk_all_labels(G, options, 4, parallel, &parallel_distances);
+  ASSERT_EQ(parallel.str(), sequential.str());
+  ASSERT_THAT(parallel_distances, ContainerEq(sequential_distances));
+  ASSERT_NE(sequential.str().find("F2V_ENTERFN"), string::npos);
+}
+
+// The join index must pair every forward path with exactly the backward paths
+// valid_match accepts, in backward order
+TEST_F(FullProgramTest, PathJoinIndexMatchesValidMatch) {
+  p2v::Llvm passes("invalid_paths.bc");
+  shared_ptr<FlowGraph> FG = passes.getFlowGraph();
+  SearchContext ctx(FG);
+
+  size_t pairs = 0;
+  BGL_FORALL_VERTICES(v, FG->G, _FlowGraph) {
+    if (!FG->is_call(v)) continue;
+    paths_t forward = __k_context(FG, v, 100, true, ctx, passes);
+    paths_t backward = __k_context(FG, v, 100, false, ctx, passes);
+    PathJoinIndex index(backward);
+
+    vector<size_t> matches;
+    for (Path &f : forward) {
+      vector<size_t> expected;
+      for (size_t i = 0; i < backward.size(); ++i) {
+        if (f.valid_match(backward[i])) expected.push_back(i);
+      }
+      index.matches(f, matches);
+      ASSERT_THAT(matches, ContainerEq(expected)) << FG->G[v].stack;
+      pairs += matches.size();
+    }
+  }
+  ASSERT_GT(pairs, 0u);
+}
+
+// A path starting at a recursive call outputs the call. Only the functions the
+// path has been in before the call hide it, not the one the call is made from.
+TEST_F(FullProgramTest, RecursiveCallStartsPath) {
+  p2v::Llvm passes("recursive.bc");
+  shared_ptr<FlowGraph> FG = passes.getFlowGraph();
+
+  flow_vertex_t recursive_call = nullptr;
+  BGL_FORALL_VERTICES(v, FG->G, _FlowGraph) {
+    if (FG->call_name(v) == "foo" && FG->function_name(FG->function(v)) == "foo") {
+      recursive_call = v;
+    }
+  }
+  ASSERT_TRUE(recursive_call);
+
+  Path p(FG);
+  p.add(recursive_call);
+  ASSERT_EQ(p.get_output_vertices().size(), 1u);
+  ASSERT_THAT(p.output(), ContainerEq(vector<string>{"foo"}));
+}
+
+// output() is cached between calls. Entering the callee of a call already on
+// the path hides that call, so the cache must not just be extended.
+TEST_F(FullProgramTest, CachedOutputFollowsAdds) {
+  p2v::Llvm passes("errpath_motivating.bc");
+  shared_ptr<FlowGraph> FG = passes.getFlowGraph();
+
+  auto fresh_output = [&](const Path &p) {
+    Path fresh(FG);
+    for (const flow_vertex_t v : p.get_vertices()) fresh.add(v);
+    return fresh.output();
+  };
+
+  size_t hidden = 0;
+  BGL_FORALL_VERTICES(v, FG->G, _FlowGraph) {
+    if (!FG->is_call(v) || FG->callees_begin(v) == FG->callees_end(v)) continue;
+    uint32_t callee = *FG->callees_begin(v);
+    if (callee == FG->function(v)) continue;
+    flow_vertex_t in_callee = nullptr;
+    BGL_FORALL_VERTICES(u, FG->G, _FlowGraph) {
+      if (FG->function(u) == callee && !FG->is_call(u)) in_callee = u;
+    }
+    if (!in_callee) continue;
+
+    Path p(FG);
+    p.add(v);
+    ASSERT_TRUE(p.has_output());
+    ASSERT_THAT(p.output(), ContainerEq(fresh_output(p)));
+    p.add(in_callee);
+    ASSERT_THAT(p.output(), ContainerEq(fresh_output(p)));
+    ASSERT_FALSE(p.has_output()) << FG->G[v].stack;
+    ++hidden;
+  }
+  ASSERT_GT(hidden, 0u);
+}
+
+// Reusing one SearchContext, and the path it holds, across call sites must
+// give the same paths as a fresh context for every call site
+TEST_F(FullProgramTest, ReusedSearchContextMatches) {
+  p2v::Llvm passes("errpath_motivating.bc");
+  shared_ptr<FlowGraph> FG = passes.getFlowGraph();
+  SearchContext reused(FG);
+
+  size_t paths = 0;
+  BGL_FORALL_VERTICES(v, FG->G, _FlowGraph) {
+    if (!FG->is_call(v)) continue;
+    for (bool forward : {true, false}) {
+      SearchContext fresh(FG);
+      paths_t expected = __k_context(FG, v, 100, forward, fresh, passes);
+      paths_t actual = __k_context(FG, v, 100, forward, reused, passes);
+      ASSERT_EQ(actual.size(), expected.size()) << FG->G[v].stack;
+      for (size_t i = 0; i < actual.size(); ++i) {
+        ASSERT_EQ(actual[i].get_vertices().size(), expected[i].get_vertices().size());
+        ASSERT_TRUE(std::equal(actual[i].get_vertices().begin(), actual[i].get_vertices().end(),
+                               expected[i].get_vertices().begin()));
+        ASSERT_THAT(actual[i].output(), ContainerEq(expected[i].output()));
+      }
+      paths += actual.size();
+    }
+  }
+  ASSERT_GT(paths, 0u);
+}
+
+// The attributes computed at finalization must agree with the edges they summarize
+TEST_F(FullProgramTest, VertexAttributesMatchEdges) {
+  p2v::Llvm passes("errpath_motivating.bc");
+  shared_ptr<FlowGraph> FG = passes.getFlowGraph();
+  ASSERT_TRUE(FG->finalized());
+
+  auto function_of = [](const string &stack) { return stack.substr(0, stack.find(".")); };
+  BGL_FORALL_VERTICES(v, FG->G, _FlowGraph) {
+    const string &stack = FG->G[v].stack;
+    ASSERT_EQ(FG->function_name(FG->function(v)), function_of(stack));
+
+    vector<string> callees;
+    bool may_ret = boost::out_degree(v, FG->G) == 0;
+    flow_vertex_t return_site = nullptr;
+    BGL_FORALL_OUTEDGES(v, e, FG->G, _FlowGraph) {
+      if (FG->G[e].call) callees.push_back(function_of(FG->G[target(e, FG->G)].stack));
+      if (FG->G[e].may_ret) may_ret = true;
+      if (FG->G[e].ret) return_site = target(e, FG->G);
+    }
+
+    vector<string> actual;
+    for (const uint32_t *fn = FG->callees_begin(v); fn != FG->callees_end(v); ++fn) {
+      actual.push_back(FG->function_name(*fn));
+    }
+    ASSERT_THAT(actual, ContainerEq(callees)) << stack;
+    ASSERT_EQ(FG->is_call(v), !callees.empty()) << stack;
+    ASSERT_EQ(FG->is_return(v), may_ret) << stack;
+    ASSERT_EQ(FG->return_site(v), return_site) << stack;
+    if (!FG->G[v].mem_index && !callees.empty()) {
+      ASSERT_EQ(FG->call_name(v), callees[0]) << stack;
+    }
+  }
+}
+
+// Paths streamed through gzip must decompress to the plain output
+TEST_F(FullProgramTest, GzipPathsRoundTrip) {
+  stringstream plain, compressed;
+  run_k_context_on_file("errpath_multi.bc", INTERESTING_TXT, plain, 100, true, true,
+                        "DEFAULT", "../../config/codes.txt");
+  {
+    ep::GzipOStream gz(compressed);
+    run_k_context_on_file("errpath_multi.bc", INTERESTING_TXT, gz, 100, true, true,
+                          "DEFAULT", "../../config/codes.txt");
+    gz.close();
+    ASSERT_TRUE(gz.good());
+  }
+
+  string in = compressed.str(), out;
+  z_stream zs;
+  memset(&zs, 0, sizeof(zs));
+  ASSERT_EQ(inflateInit2(&zs, 15 + 16), Z_OK);
+  zs.next_in = reinterpret_cast<Bytef*>(&in[0]);
+  zs.avail_in = in.size();
+  char chunk[4096];
+  int ret;
+  do {
+    zs.next_out = reinterpret_cast<Bytef*>(chunk);
+    zs.avail_out = sizeof(chunk);
+    ret = inflate(&zs, Z_NO_FLUSH);
+    ASSERT_TRUE(ret == Z_OK || ret == Z_STREAM_END) << ret;
+    out.append(chunk, sizeof(chunk) - zs.avail_out);
+  } while (ret != Z_STREAM_END);
+  inflateEnd(&zs);
+
+  ASSERT_FALSE(plain.str().empty());
+  ASSERT_THAT(sorted_lines(out), ContainerEq(sorted_lines(plain.str())));
+}
+
+// Decoding a binary corpus through its vocabulary gives back the text paths,
+// and the vocabulary is the same whatever the number of threads
+TEST_F(FullProgramTest, CorpusPathsRoundTrip) {
+  stringstream plain;
+  run_k_context_on_file("errpath_multi.bc", INTERESTING_TXT, plain, 100, true, true,
+                        "DEFAULT", "../../config/codes.txt");
+
+  vector<vector<string>> vocabs;
+  for (unsigned threads : {1u, 4u}) {
+    string corpus_path = "errpath_multi.corpus." + to_string(threads);
+    {
+      ofstream corpus(corpus_path, ios::binary);
+      run_k_context_on_file("errpath_multi.bc", INTERESTING_TXT, corpus, 100, true, true,
+                            "DEFAULT", "../../config/codes.txt", "", threads, corpus_path + ".vocab");
+    }
+
+    vector<string> vocab;
+    ASSERT_TRUE(ep::read_vocabulary(corpus_path + ".vocab", vocab));
+    ep::CorpusReader reader(corpus_path);
+    ASSERT_TRUE(reader.ok());
+    string decoded;
+    vector<uint32_t> sentence;
+    while (reader.next(sentence)) {
+      decoded += "PATH_BEGIN ";
+      for (uint32_t id : sentence) {
+        ASSERT_LT(id, vocab.size());
+        decoded += vocab[id] + " ";
+      }
+      decoded += "PATH_END\n";
+    }
+    ASSERT_FALSE(plain.str().empty());
+    ASSERT_THAT(sorted_lines(decoded), ContainerEq(sorted_lines(plain.str())));
+    vocabs.push_back(vocab);
+
+    unlink(corpus_path.c_str());
+    unlink((corpus_path + ".vocab").c_str());
+  }
+  ASSERT_THAT(vocabs[1], ContainerEq(vocabs[0]));
+}
+
+// Each function's tree is built once while it fits the budget, and rebuilt
+// after eviction when it does not
+TEST_F(FullProgramTest, PostDomCacheBuildsOncePerFunction) {
+  llvm::SMDiagnostic Err;
+  unique_ptr<llvm::Module> Mod(llvm::parseIRFile("errpath_multi.bc", Err, llvm::getGlobalContext()));
+  ASSERT_TRUE(Mod);
+
+  vector<llvm::Function*> functions;
+  for (llvm::Function &F : *Mod) {
+    if (!F.isDeclaration()) {
+      functions.push_back(&F);
+    }
+  }
+  ASSERT_GT(functions.size(), 1u);
+
+  ep::PostDomCache cache;
+  for (int round = 0; round < 3; ++round) {
+    for (llvm::Function *F : functions) {
+      llvm::PostDominatorTree &postdom = cache.get(*F);
+      ASSERT_TRUE(postdom.dominates(&F->back(), &F->back()));
+    }
+  }
+  ASSERT_EQ(cache.builds(), functions.size());
+  ASSERT_EQ(cache.lookups(), 3 * functions.size());
+
+  // Room for a single tree, so alternating functions always rebuild
+  ep::PostDomCache small(1);
+  small.get(*functions[0]);
+  small.get(*functions[1]);
+  small.get(*functions[0]);
+  ASSERT_EQ(small.builds(), 3u);
+}
+
+struct RandomEdge {
+  bool follow = true;
+};
+typedef boost::adjacency_list<boost::vecS, boost::vecS, boost::bidirectionalS,
+                              boost::no_property, RandomEdge> RandomGraph;
+
+// Records discovered vertices in order, and follows the edges marked follow
+class RecordingVisitor : public ep::DFSVisitorInterface<RandomGraph> {
+public:
+  void discover_vertex(RandomGraph::vertex_descriptor v, RandomGraph &) override {
+    discovered.push_back(v);
+  }
+  bool follow_edge(const RandomGraph::edge_descriptor e, const RandomGraph &G) const override {
+    return G[e].follow;
+  }
+  vector<RandomGraph::vertex_descriptor> discovered;
+};
+
+// The epoch-array DepthFirstVisitor must find what the old map- and set-based
+// one found: the same reachable vertices in the same order, and the same
+// vertices between, on small graphs with cycles, unfollowed edges and ends
+// that cannot be reached
+TEST_F(FullProgramTest, EnumerateBetweenMatchesSetBased) {
+  mt19937 rng(2018);
+  size_t nonempty = 0, empty = 0;
+  for (int graph = 0; graph < 300; ++graph) {
+    unsigned n = 2 + rng() % 11;
+    RandomGraph G(n);
+    unsigned edges = rng() % (2 * n + 1);
+    for (unsigned k = 0; k < edges; ++k) {
+      RandomEdge props;
+      props.follow = rng() % 5 != 0;
+      add_edge(rng() % n, rng() % n, props, G);
+    }
+
+    for (unsigned start = 0; start < n; ++start) {
+      RecordingVisitor expected, actual;
+      SetBasedDFS<RandomGraph>(expected).visit(start, G);
+      ep::DepthFirstVisitor<RandomGraph>(actual).visit(start, G);
+      ASSERT_THAT(actual.discovered, ContainerEq(expected.discovered)) << "graph " << graph;
+
+      for (unsigned end = 0; end < n; ++end) {
+        RecordingVisitor expected_between, actual_between;
+        SetBasedDFS<RandomGraph>(expected_between).visit(start, end, G);
+        ep::DepthFirstVisitor<RandomGraph>(actual_between, ep::DepthFirstVisitor<RandomGraph>::Between::ENUMERATE)
+          .visit(start, end, G);
+        set<RandomGraph::vertex_descriptor> e(expected_between.discovered.begin(), expected_between.discovered.end());
+        set<RandomGraph::vertex_descriptor> a(actual_between.discovered.begin(), actual_between.discovered.end());
+        ASSERT_EQ(actual_between.discovered.size(), a.size());
+        ASSERT_THAT(a, ContainerEq(e)) << "graph " << graph << " from " << start << " to " << end;
+        if (e.empty()) ++empty; else ++nonempty;
+      }
+    }
+  }
+  ASSERT_GT(nonempty, 0u);
+  ASSERT_GT(empty, 0u);
+}
+
+// From every function entry to every vertex of the function, the sweeps find
+// everything the enumerator finds, and nothing when the vertex is unreachable
+TEST_F(FullProgramTest, BetweenSweepContainsEnumerated) {
+  p2v::Llvm passes("errpath_motivating.bc");
+  shared_ptr<FlowGraph> FG = passes.getFlowGraph();
+
+  map<uint32_t, flow_vertex_t> entries;
+  BGL_FORALL_EDGES(e, FG->G, _FlowGraph) {
+    if (FG->G[e].call) {
+      entries[FG->function(target(e, FG->G))] = target(e, FG->G);
+    }
+  }
+  ASSERT_FALSE(entries.empty());
+
+  size_t searches = 0;
+  BGL_FORALL_VERTICES(v, FG->G, _FlowGraph) {
+    auto entry = entries.find(FG->function(v));
+    if (entry == entries.end()) continue;
+
+    set<flow_vertex_t> swept = pre_action_between(entry->second, v, FG->G, PreActionDFS::Between::SWEEP);
+    set<flow_vertex_t> enumerated = pre_action_between(entry->second, v, FG->G, PreActionDFS::Between::ENUMERATE);
+    for (flow_vertex_t u : enumerated) {
+      ASSERT_TRUE(swept.count(u));
+    }
+    ASSERT_EQ(swept.empty(), !pre_action_reachable(entry->second, FG->G).count(v));
+    ++searches;
+  }
+  ASSERT_GT(searches, 0u);
+}
+
+// The handler after foo() calls exit, so it has no join block with the normal
+// path. Only that branch is skipped; the bar() handler after it is still found.
+TEST_F(FullProgramTest, HandlersSkipBranchWithoutJoin) {
+  char ec_path[] = "/tmp/f2v-codes-XXXXXX";
+  int fd = mkstemp(ec_path);
+  ASSERT_GE(fd, 0);
+  close(fd);
+  {
+    ofstream codes(ec_path);
+    codes << "EIO 5\n";
+  }
+
+  llvm::SMDiagnostic Err;
+  unique_ptr<llvm::Module> Mod(llvm::parseIRFile("errpath_noreturn.bc", Err, llvm::getGlobalContext()));
+  ASSERT_TRUE(Mod);
+
+  llvm::legacy::PassManager PM;
+  HandlersPass *handlers = new HandlersPass();
+  PM.add(new NamesPass(ec_path));
+  PM.add(new BranchSafetyPass());
+  PM.add(handlers);
+  PM.run(*Mod);
+  unlink(ec_path);
+
+  // Both branches test a call
+  string foo_branch, bar_branch;
+  for (const auto &kv : handlers->returning_functions_by_id) {
+    if (kv.second == "foo") foo_branch = kv.first;
+    if (kv.second == "bar") bar_branch = kv.first;
+  }
+  ASSERT_FALSE(foo_branch.empty());
+  ASSERT_FALSE(bar_branch.empty());
+
+  ASSERT_EQ(handlers->eh_vertices.size(), 1u);
+  ASSERT_EQ(handlers->eh_vertices.count(foo_branch), 0u);
+  ASSERT_EQ(handlers->eh_vertices.count(bar_branch), 1u);
+
+  string not_handler, handler_on, handler_off;
+  tie(not_handler, handler_on, handler_off) = handlers->eh_vertices.at(bar_branch);
+  ASSERT_NE(handler_on, not_handler);
+  // bar() has no else, so the join is the block the normal path takes
+  ASSERT_EQ(handler_off, not_handler);
+  ASSERT_EQ(handlers->handler_to_branch.at(not_handler), bar_branch);
+  ASSERT_EQ(handlers->handler_to_branch.at(handler_on), bar_branch);
+  ASSERT_EQ(handlers->handler_to_branch.size(), 2u);
+
+  ASSERT_EQ(handlers->timings.size(), 1u);
+  ASSERT_EQ(handlers->timings[0].function, "main");
+  ASSERT_EQ(handlers->timings[0].branches, 2u);
+  ASSERT_EQ(handlers->timings[0].handlers, 1u);
+}
+
+TEST_F(FullProgramTest, FlatMapMatchesStdMap) {
+  vector<int> values(1000);
+  map<int*, int> tree;
+  ep::FlatMap<int*, int> flat;
+
+  // Keep a reference across many inserts, as NamesPass does with names[&I]
+  int &first = flat[&values[0]];
+  for (size_t i = 0; i < 5000; ++i) {
+    int *key = &values[(i * 7919) % values.size()];
+    tree[key] += i;
+    flat[key] += i;
+  }
+  first += 1;
+  tree[&values[0]] += 1;
+
+  ASSERT_EQ(tree.size(), flat.size());
+  for (const auto &kv : tree) {
+    ASSERT_EQ(kv.second, flat.at(kv.first));
+  }
+  ASSERT_TRUE(flat.find(nullptr) == flat.end());
+  ASSERT_FALSE(flat.insert(make_pair(&values[0], -1)).second);
+  ASSERT_EQ(flat.begin()->first, &values[0]);
+}
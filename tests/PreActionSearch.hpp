@@ -0,0 +1,40 @@
+// Runs the searches tracegen makes for pre-actions, through PreActionVisitor
+// itself, so tests and benchmarks follow exactly the edges it follows.
+
+#ifndef PREACTIONSEARCH_HPP
+#define PREACTIONSEARCH_HPP
+
+#include "TraceVisitors.hpp"
+#include <set>
+#include <vector>
+
+// Maps every instruction to no actions, so a visitor only records what it discovers
+class NoActionMapper : public ActionMapper {
+public:
+  std::vector<Item> map(const llvm::Instruction *, const Location &) override {
+    return std::vector<Item>();
+  }
+};
+
+typedef ep::DepthFirstVisitor<_FlowGraph> PreActionDFS;
+
+// Vertices between start and end, as Traces collects pre-actions from them
+inline std::set<flow_vertex_t> pre_action_between(flow_vertex_t start, flow_vertex_t end, _FlowGraph &G,
+                                                  PreActionDFS::Between engine) {
+  NoActionMapper mapper;
+  std::vector<Item> actions;
+  PreActionVisitor visitor(mapper, actions);
+  PreActionDFS(visitor, engine).visit(start, end, G);
+  return visitor.get_discovered();
+}
+
+// Vertices reachable from start over the edges PreActionVisitor follows
+inline std::set<flow_vertex_t> pre_action_reachable(flow_vertex_t start, _FlowGraph &G) {
+  NoActionMapper mapper;
+  std::vector<Item> actions;
+  PreActionVisitor visitor(mapper, actions);
+  PreActionDFS(visitor).visit(start, G);
+  return visitor.get_discovered();
+}
+
+#endif
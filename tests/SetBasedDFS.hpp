@@ -0,0 +1,135 @@
+// The map- and set-based DepthFirstVisitor searches from before the marks
+// moved to epoch arrays, kept to check the current ones against.
+
+#ifndef SETBASEDDFS_HPP
+#define SETBASEDDFS_HPP
+
+#include "Utility.hpp"
+#include <map>
+#include <set>
+#include <stack>
+#include <vector>
+
+template<class GraphT>
+class SetBasedDFS {
+  typedef typename boost::graph_traits<GraphT>::vertex_descriptor vertex_t;
+  typedef typename boost::graph_traits<GraphT>::out_edge_iterator oei_t;
+
+public:
+  SetBasedDFS(ep::DFSVisitorInterface<GraphT> &visitor) : visitor(visitor) {}
+
+  void visit(vertex_t start_vtx, GraphT &G) {
+    std::map<vertex_t, bool> visited;
+    std::stack<vertex_t> pending;
+    pending.push(start_vtx);
+
+    oei_t oei, oei_end;
+    while (!pending.empty()) {
+      vertex_t next = pending.top();
+      pending.pop();
+
+      if (visited.find(next) == visited.end()) {
+        visitor.discover_vertex(next, G);
+      }
+
+      visited[next] = true;
+
+      for (std::tie(oei, oei_end) = out_edges(next, G); oei != oei_end; ++oei) {
+        vertex_t v = target(*oei, G);
+        if (visited.find(v) == visited.end() && visitor.follow_edge(*oei, G)) {
+          pending.push(v);
+        }
+      }
+    }
+  }
+
+  void visit(vertex_t start_vtx, vertex_t end_vtx, GraphT &G) {
+    bool success = false;
+    std::vector<std::pair<vertex_t, std::set<vertex_t>>> pending_branches;
+    std::set<vertex_t> path;
+    std::map<vertex_t, bool> visited;
+    std::set<vertex_t> between;
+
+    auto end_branch_fn = [&]() {
+      if (success) {
+        between.insert(path.begin(), path.end());
+      }
+      pending_branches.pop_back();
+      success = false;
+    };
+
+    pending_branches.push_back(std::make_pair(start_vtx, std::set<vertex_t>()));
+
+    bool chain_node = false;
+    vertex_t next;
+    while (!pending_branches.empty() || chain_node) {
+      if (!chain_node) {
+        next = std::get<0>(pending_branches.back());
+        path = std::get<1>(pending_branches.back());
+      }
+
+      bool next_between = between.find(next) != between.end();
+
+      if ((visited.find(next) != visited.end() && !next_between)
+          || path.find(next) != path.end()) {
+        chain_node = false;
+        end_branch_fn();
+        continue;
+      }
+
+      path.insert(next);
+      visited[next] = true;
+
+      if (next == end_vtx || next_between) {
+        chain_node = false;
+        success = true;
+        end_branch_fn();
+        continue;
+      }
+
+      oei_t oei, oei_end;
+      if (follow_degree(next, G) == 0) {
+        chain_node = false;
+        end_branch_fn();
+      } else if (follow_degree(next, G) == 1) {
+        chain_node = true;
+
+        for (std::tie(oei, oei_end) = out_edges(next, G); oei != oei_end; ++oei) {
+          if (visitor.follow_edge(*oei, G)) {
+            next = target(*oei, G);
+            break;
+          }
+        }
+      } else {
+        chain_node = false;
+        for (std::tie(oei, oei_end) = out_edges(next, G); oei != oei_end; ++oei) {
+          if (visitor.follow_edge(*oei, G)) {
+            pending_branches.push_back(std::make_pair(target(*oei, G), path));
+          }
+        }
+      }
+    }
+
+    for (vertex_t v : between) {
+      visitor.discover_vertex(v, G);
+    }
+  }
+
+private:
+  unsigned follow_degree(const vertex_t v, const GraphT &G) const {
+    unsigned ret = 0;
+
+    oei_t oei, oei_end;
+    for (std::tie(oei, oei_end) = out_edges(v, G); oei != oei_end; ++oei) {
+      if (visitor.follow_edge(*oei, G)) {
+        ++ret;
+      }
+    }
+
+    return ret;
+  }
+
+  ep::DFSVisitorInterface<GraphT> &visitor;
+};
+
+#endif
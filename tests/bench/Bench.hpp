@@ -0,0 +1,11 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <chrono>
+
+// Wall-clock seconds since start, for the benchmarks in this directory
+inline double seconds_since(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+#endif
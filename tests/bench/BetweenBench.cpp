@@ -0,0 +1,105 @@
+// Compares the two ways DepthFirstVisitor finds the vertices between a
+// function entry and a vertex in it, running PreActionVisitor as Traces does.
+//
+// For every function entered by a call edge, searches from the entry to up to
+// <targets> vertices of the function, spread evenly, with both the reachability
+// sweeps and the old branch enumerator. Reports the time per search, and how
+// many searches disagree. The enumerator can only miss vertices, never add them.
+// Usage: betweenbench <targets> <file.bc>...
+
+#include "Bench.hpp"
+#include "Llvm.hpp"
+#include "PreActionSearch.hpp"
+#include <chrono>
+#include <iostream>
+#include <set>
+
+using namespace std;
+using namespace p2v;
+
+namespace {
+
+struct Search {
+  flow_vertex_t entry;
+  flow_vertex_t target;
+};
+
+// Vertices found by each search, one after the other
+vector<set<flow_vertex_t>> run(const vector<Search> &searches, FlowGraph &FG,
+                               PreActionDFS::Between engine, double &seconds) {
+  vector<set<flow_vertex_t>> ret;
+  ret.reserve(searches.size());
+  auto start = chrono::steady_clock::now();
+  for (const Search &s : searches) {
+    ret.push_back(pre_action_between(s.entry, s.target, FG.G, engine));
+  }
+  seconds = seconds_since(start);
+  return ret;
+}
+
+}
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    cerr << "Usage: betweenbench <targets> <file.bc>..." << endl;
+    return 1;
+  }
+  size_t max_targets = stoul(argv[1]);
+
+  for (int i = 2; i < argc; ++i) {
+    Llvm passes(argv[i]);
+    shared_ptr<FlowGraph> FG = passes.getFlowGraph();
+
+    vector<flow_vertex_t> entries(FG->num_functions(), nullptr);
+    BGL_FORALL_EDGES(e, FG->G, _FlowGraph) {
+      if (FG->G[e].call) {
+        flow_vertex_t v = target(e, FG->G);
+        entries[FG->function(v)] = v;
+      }
+    }
+    vector<vector<flow_vertex_t>> members(FG->num_functions());
+    BGL_FORALL_VERTICES(v, FG->G, _FlowGraph) {
+      members[FG->function(v)].push_back(v);
+    }
+
+    vector<Search> searches;
+    for (uint32_t fn = 0; fn < FG->num_functions(); ++fn) {
+      if (!entries[fn] || members[fn].empty()) continue;
+      sort(members[fn].begin(), members[fn].end(), [&](flow_vertex_t a, flow_vertex_t b) {
+        return FG->G[a].index < FG->G[b].index;
+      });
+      size_t n = min(max_targets, members[fn].size());
+      for (size_t k = 0; k < n; ++k) {
+        searches.push_back(Search{entries[fn], members[fn][k * members[fn].size() / n]});
+      }
+    }
+
+    double sweep_seconds, enumerate_seconds;
+    auto swept = run(searches, *FG, PreActionDFS::Between::SWEEP, sweep_seconds);
+    auto enumerated = run(searches, *FG, PreActionDFS::Between::ENUMERATE, enumerate_seconds);
+
+    size_t differ = 0, swept_vertices = 0, enumerated_vertices = 0;
+    for (size_t k = 0; k < searches.size(); ++k) {
+      swept_vertices += swept[k].size();
+      enumerated_vertices += enumerated[k].size();
+      if (swept[k].size() != enumerated[k].size()) {
+        ++differ;
+      }
+      for (flow_vertex_t v : enumerated[k]) {
+        if (swept[k].find(v) == swept[k].end()) {
+          cerr << "FATAL ERROR: Enumerator found a vertex the sweeps did not" << endl;
+          abort();
+        }
+      }
+    }
+
+    size_t n = max<size_t>(searches.size(), 1);
+    cerr << argv[i] << ": " << searches.size() << " searches, "
+         << "sweep " << sweep_seconds * 1e6 / n << " us/search, "
+         << "enumerate " << enumerate_seconds * 1e6 / n << " us/search, "
+         << differ << " differ (" << swept_vertices << " vs " << enumerated_vertices << " vertices)"
+         << endl;
+  }
+
+  return 0;
+}
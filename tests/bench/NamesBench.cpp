@@ -0,0 +1,128 @@
+// Measures NamesPass name lookups on whole modules.
+//
+// Runs NamesPass alone on each bitcode file and times the visitor phase. Then
+// asks getVarName for every instruction and every operand in the module, as
+// ControlFlowPass and InstructionLabelsPass do, [rounds] times over. The same
+// key stream is finally replayed against a std::map (the old names table) and
+// an ep::FlatMap holding the same names, so both tables are compared on
+// identical lookups. The two replays must find the same number of names.
+// Usage: namesbench <rounds> <file.bc>...
+
+#include "Bench.hpp"
+#include "Names.hpp"
+#include "FlatMap.hpp"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IRReader/IRReader.h"
+#include "llvm/Support/SourceMgr.h"
+#include <chrono>
+#include <iostream>
+#include <map>
+
+using namespace std;
+using namespace llvm;
+
+namespace {
+
+// Every instruction and its operands, in module order
+vector<const Value*> lookup_keys(Module &M) {
+  vector<const Value*> keys;
+  for (Function &F : M) {
+    for (BasicBlock &BB : F) {
+      for (Instruction &I : BB) {
+        keys.push_back(&I);
+        for (const Use &U : I.operands()) {
+          keys.push_back(U.get());
+        }
+      }
+    }
+  }
+  return keys;
+}
+
+template <typename Table>
+size_t replay(const Table &table, const vector<const Value*> &keys, unsigned rounds, double &seconds) {
+  size_t found = 0;
+  auto start = chrono::steady_clock::now();
+  for (unsigned r = 0; r < rounds; ++r) {
+    for (const Value *key : keys) {
+      if (table.find(key) != table.end()) {
+        ++found;
+      }
+    }
+  }
+  seconds = seconds_since(start);
+  return found;
+}
+
+double rate(size_t lookups, double seconds) {
+  return seconds > 0 ? lookups / seconds / 1e6 : 0;
+}
+
+}
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    cerr << "Usage: namesbench <rounds> <file.bc>..." << endl;
+    return 1;
+  }
+  unsigned rounds = stoul(argv[1]);
+
+  for (int i = 2; i < argc; ++i) {
+    SMDiagnostic Err;
+    unique_ptr<Module> Mod(parseIRFile(argv[i], Err, getGlobalContext()));
+    if (!Mod) {
+      cerr << "FATAL: Error parsing bitcode file: " << argv[i] << endl;
+      abort();
+    }
+
+    // The pass manager owns the pass, so keep it alive while we ask questions
+    legacy::PassManager PM;
+    NamesPass *names = new NamesPass();
+    PM.add(names);
+    auto start = chrono::steady_clock::now();
+    PM.run(*Mod);
+    double visit_seconds = seconds_since(start);
+
+    vector<const Value*> keys = lookup_keys(*Mod);
+    size_t lookups = keys.size() * rounds;
+
+    size_t named = 0;
+    start = chrono::steady_clock::now();
+    for (unsigned r = 0; r < rounds; ++r) {
+      for (const Value *key : keys) {
+        if (names->getVarName(key)) {
+          ++named;
+        }
+      }
+    }
+    double getvarname_seconds = seconds_since(start);
+
+    map<const Value*, vn_t> tree;
+    ep::FlatMap<const Value*, vn_t> flat;
+    for (const Value *key : keys) {
+      vn_t vn = names->getVarName(key);
+      if (vn) {
+        tree[key] = vn;
+        flat[key] = vn;
+      }
+    }
+
+    double tree_seconds, flat_seconds;
+    size_t tree_found = replay(tree, keys, rounds, tree_seconds);
+    size_t flat_found = replay(flat, keys, rounds, flat_seconds);
+    if (tree_found != flat_found) {
+      cerr << "FATAL ERROR: std::map and FlatMap found different names" << endl;
+      abort();
+    }
+
+    cerr << argv[i] << ": visit " << visit_seconds * 1e3 << " ms, "
+         << keys.size() << " keys, " << named / max(rounds, 1u) << " named, "
+         << "getVarName " << rate(lookups, getvarname_seconds) << " M/s, "
+         << "std::map " << rate(lookups, tree_seconds) << " M/s, "
+         << "FlatMap " << rate(lookups, flat_seconds) << " M/s"
+         << endl;
+  }
+
+  return 0;
+}
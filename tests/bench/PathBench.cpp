@@ -0,0 +1,116 @@
+// Compares deduplicating k_context paths by callsite string and by signature.
+//
+// Runs __k_context from every call site of each bitcode file, then replays
+// the dedup work of __k_context and k_context (every path, and every forward /
+// backward pair) with both kinds of keys. The string keys are the old ones: a
+// pair is keyed by the two callsite strings concatenated, so pairs that split the
+// same string differently were merged. Signatures keep them apart, so they can
+// only count more distinct keys, never fewer.
+// Usage: pathbench <path length> <file.bc>...
+
+#include "Bench.hpp"
+#include "Context.hpp"
+#include <chrono>
+#include <iostream>
+#include <unordered_set>
+
+using namespace std;
+using namespace p2v;
+
+namespace {
+
+const unsigned REPEATS = 5;
+
+struct CallSitePaths {
+  paths_t forward;
+  paths_t backward;
+};
+
+size_t dedup_strings(const vector<CallSitePaths> &sites) {
+  size_t distinct = 0;
+  for (const CallSitePaths &site : sites) {
+    unordered_set<string> paths, pairs;
+    for (const Path &f : site.forward) {
+      paths.insert(f.get_callsite_sequence_idx());
+      for (const Path &b : site.backward) {
+        pairs.insert(f.get_callsite_sequence_idx() + b.get_callsite_sequence_idx());
+      }
+    }
+    for (const Path &b : site.backward) {
+      paths.insert(b.get_callsite_sequence_idx());
+    }
+    distinct += paths.size() + pairs.size();
+  }
+  return distinct;
+}
+
+size_t dedup_signatures(const vector<CallSitePaths> &sites) {
+  size_t distinct = 0;
+  for (const CallSitePaths &site : sites) {
+    unordered_set<PathSignature, PathSignatureHash> paths, pairs;
+    for (const Path &f : site.forward) {
+      paths.insert(f.signature());
+      for (const Path &b : site.backward) {
+        pairs.insert(PathSignature::join(f.signature(), b.signature()));
+      }
+    }
+    for (const Path &b : site.backward) {
+      paths.insert(b.signature());
+    }
+    distinct += paths.size() + pairs.size();
+  }
+  return distinct;
+}
+
+}
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    cerr << "Usage: pathbench <path length> <file.bc>..." << endl;
+    return 1;
+  }
+  unsigned path_length = stoul(argv[1]);
+
+  for (int i = 2; i < argc; ++i) {
+    Llvm passes(argv[i]);
+    shared_ptr<FlowGraph> FG = passes.getFlowGraph();
+    SearchContext ctx(FG);
+
+    vector<CallSitePaths> sites;
+    size_t keys = 0;
+    BGL_FORALL_VERTICES(v, FG->G, _FlowGraph) {
+      if (!FG->is_call(v)) continue;
+      CallSitePaths site;
+      site.forward = __k_context(FG, v, path_length, true, ctx, passes);
+      site.backward = __k_context(FG, v, path_length, false, ctx, passes);
+      keys += site.forward.size() + site.backward.size() + site.forward.size() * site.backward.size();
+      sites.push_back(move(site));
+    }
+
+    size_t strings = 0, signatures = 0;
+    auto start = chrono::steady_clock::now();
+    for (unsigned r = 0; r < REPEATS; ++r) {
+      strings = dedup_strings(sites);
+    }
+    double string_seconds = seconds_since(start);
+
+    start = chrono::steady_clock::now();
+    for (unsigned r = 0; r < REPEATS; ++r) {
+      signatures = dedup_signatures(sites);
+    }
+    double signature_seconds = seconds_since(start);
+
+    cerr << argv[i] << ": " << sites.size() << " call sites, " << keys << " keys, "
+         << "strings " << string_seconds * 1e9 / (REPEATS * max<size_t>(keys, 1)) << " ns/key, "
+         << "signatures " << signature_seconds * 1e9 / (REPEATS * max<size_t>(keys, 1)) << " ns/key, "
+         << signatures - min(strings, signatures) << " pairs merged by the string keys"
+         << endl;
+    if (signatures < strings) {
+      cerr << "FATAL ERROR: " << strings << " distinct strings but " << signatures
+           << " distinct signatures" << endl;
+      abort();
+    }
+  }
+
+  return 0;
+}
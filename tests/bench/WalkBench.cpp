@@ -0,0 +1,104 @@
+// Microbenchmark for the walkgen transition step.
+//
+// Builds a synthetic ICFG shaped like a kernel (many small functions, a few
+// indirect call sites with thousands of targets) and reports walker steps per
+// second. Usage: walkbench [functions] [hub targets] [threads]
+
+#include "Bench.hpp"
+#include "PushDown.hpp"
+#include "WalkScheduler.hpp"
+#include "Parallel.hpp"
+#include <chrono>
+#include <iostream>
+#include <random>
+
+using namespace std;
+
+namespace {
+
+const unsigned INSTRUCTIONS = 40;
+const unsigned CALL_EVERY = 8;
+const unsigned HUBS = 64;
+const unsigned LABELS = 2000;
+
+string stack_name(unsigned fn, unsigned iid) {
+  return "f" + to_string(fn) + "." + to_string(iid);
+}
+
+}
+
+int main(int argc, char **argv) {
+  unsigned functions = argc > 1 ? stoul(argv[1]) : 20000;
+  unsigned hub_targets = argc > 2 ? stoul(argv[2]) : 2000;
+  unsigned threads = ep::resolve_threads(argc > 3 ? stoul(argv[3]) : 0);
+
+  auto start = chrono::steady_clock::now();
+  mt19937 rng(0);
+  FlowGraph FG;
+  vector<vector<string>> return_sites(functions);
+  unsigned hubs = 0;
+  for (unsigned f = 0; f < functions; ++f) {
+    for (unsigned i = 0; i + 1 < INSTRUCTIONS; ++i) {
+      FlowVertex from(stack_name(f, i), Location(), nullptr);
+      from.label_ids.push_back(rng() % LABELS);
+      if (i % CALL_EVERY == CALL_EVERY - 1) {
+        unsigned targets = hubs < HUBS && rng() % 100 == 0 ? hub_targets : 1;
+        hubs += targets > 1;
+        for (unsigned t = 0; t < targets; ++t) {
+          unsigned callee = rng() % functions;
+          FG.add(from, FlowVertex(stack_name(callee, 0), Location(), nullptr),
+                 FlowVertex(stack_name(f, i + 1), Location(), nullptr));
+          return_sites[callee].push_back(stack_name(f, i + 1));
+        }
+      } else {
+        FG.add(from, FlowVertex(stack_name(f, i + 1), Location(), nullptr));
+        if (i % 5 == 0 && i + 2 < INSTRUCTIONS) {
+          FG.add(from, FlowVertex(stack_name(f, i + 2), Location(), nullptr));
+        }
+      }
+    }
+  }
+  for (unsigned f = 0; f < functions; ++f) {
+    flow_vertex_t exit = FG.getVertex(stack_name(f, INSTRUCTIONS - 1));
+    for (const string &site : return_sites[f]) {
+      flow_edge_t e;
+      tie(e, std::ignore) = boost::add_edge(exit, FG.getVertex(site), FG.G);
+      FG.G[e].may_ret = true;
+    }
+  }
+  FG.finalize();
+
+  unordered_map<int, string> id_to_label;
+  for (unsigned l = 0; l < LABELS; ++l) {
+    id_to_label[l] = "L" + to_string(l);
+  }
+  CompactFlowGraph CFG(FG);
+  PushDownGraph G(CFG, id_to_label, {}, true);
+  cerr << "Graph: " << num_vertices(CFG) << " vertices, " << num_edges(CFG) << " edges, "
+       << hubs << " hub call sites, built in " << seconds_since(start) << "s" << endl;
+
+  // Single walker, no output
+  PushDownWalker walker(G, false, true, 1.0);
+  vector<int> walk;
+  uint64_t steps = 0;
+  start = chrono::steady_clock::now();
+  for (uint64_t i = 0; seconds_since(start) < 2.0; ++i) {
+    for (size_t label = 0; label < G.label_to_starts.size(); ++label) {
+      walk.clear();
+      steps += walker.randomWalk(200, label, mix_seed(i, label), walk);
+    }
+  }
+  double elapsed = seconds_since(start);
+  cerr << "1 thread: " << (uint64_t) (steps / elapsed) << " steps/s" << endl;
+
+  // Full scheduler, including formatting and the merge
+  WalkOptions options;
+  options.walks_per_label = 20;
+  ostream null_stream(nullptr);
+  start = chrono::steady_clock::now();
+  walk_all_labels(G, options, threads, null_stream);
+  cerr << threads << " threads: " << options.walks_per_label * G.label_to_starts.size() << " walks in "
+       << seconds_since(start) << "s" << endl;
+
+  return 0;
+}
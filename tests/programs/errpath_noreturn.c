@@ -0,0 +1,17 @@
+// The handler of the first branch never returns, so it has no join block with
+// the normal path. HandlersPass skips it and still finds the handler after it.
+
+void exit(int) __attribute__((noreturn));
+int foo();
+int bar();
+int baz();
+
+int main() {
+  if (foo()) {
+    exit(1);
+  }
+  if (bar()) {
+    baz();
+  }
+  return 0;
+}
@@ -0,0 +1,44 @@
+// A few thousand small functions, so the ICFG is large enough for memory
+// measurements to rise above page and allocator noise
+
+int check(int x);
+void report(int x);
+
+int check(int x) {
+  if (x < 0) {
+    report(x);
+    return -1;
+  }
+  return x;
+}
+
+void report(int x) {
+  if (x < -10) {
+    check(x + 1);
+  }
+}
+
+#define FN(n) \
+  int f##n(int x) { \
+    int y = check(x); \
+    if (y < 0) { \
+      report(y); \
+      return y; \
+    } \
+    if (y > n) { \
+      y = check(y - n); \
+    } \
+    return y + n; \
+  }
+
+#define D1(p) FN(p##0) FN(p##1) FN(p##2) FN(p##3) FN(p##4) FN(p##5) FN(p##6) FN(p##7) FN(p##8) FN(p##9)
+#define D2(p) D1(p##0) D1(p##1) D1(p##2) D1(p##3) D1(p##4) D1(p##5) D1(p##6) D1(p##7) D1(p##8) D1(p##9)
+#define D3(p) D2(p##0) D2(p##1) D2(p##2) D2(p##3) D2(p##4) D2(p##5) D2(p##6) D2(p##7) D2(p##8) D2(p##9)
+
+D3(1)
+D3(2)
+D3(3)
+
+int main(int argc, char **argv) {
+  return f1000(argc) + f2999(argc) + f3999(argc);
+}